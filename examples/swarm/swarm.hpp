@@ -177,6 +177,16 @@ class Swarm : public Surface<Swarm<_value_type, fluid_solver, time_integrator> >
             return m_geometry;
         }
 
+        /**
+         * \brief Particle offsets of each body, used to set up block and rigid body preconditioners.
+         **/
+        void getBodyOffsets(std::vector<size_t> &body_ptr)
+        {
+            body_ptr.resize(m_num_geometries + 1);
+            for(int i = 0; i <= m_num_geometries; ++i)
+                body_ptr[i] = i * m_geometry.numParticles();
+        }
+
 
 
 };
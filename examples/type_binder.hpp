@@ -26,6 +26,10 @@ struct Traits;
 #include "math/ode_solver/euler/backward_euler.hpp"
 #include "math/ode_solver/sdc/explicit_sdc.hpp"
 #include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/ark/additive_runge_kutta.hpp"
+#include "math/ode_solver/sdc/stiffness_switching_sdc.hpp"
+#include "math/ode_solver/multistep/adams_bashforth.hpp"
+#include "math/ode_solver/sdc/multirate_sdc.hpp"
 #include "examples/valveless_heart/valveless_heart.hpp"
 #include "examples/swarm/swarm.hpp"
 #include "examples/glycocalyx/glycocalyx.hpp"
@@ -58,13 +62,19 @@ struct TypeBinder
     typedef Integrator<value_type, gauss_lobatto, sdc_nodes>                    spectral_integrator;
     typedef ExplicitSDC<value_type, spectral_integrator, sdc_corrections>       explicit_sdc;
     typedef SemiImplicitSDC<value_type, spectral_integrator, sdc_corrections>   implicit_sdc;
+    typedef AdditiveRungeKutta<value_type, ARK324L2SA>                          ark3;
+    typedef AdditiveRungeKutta<value_type, ARK436L2SA>                          ark4;
+    typedef StiffnessSwitchingSDC<value_type, explicit_sdc, implicit_sdc>       switching_sdc;
+    typedef AdamsBashforth<value_type, 4>                                       adams_bashforth;
+    typedef Integrator<value_type, gauss_lobatto, sdc_nodes, 5>                 multirate_integrator;
+    typedef MultirateSDC<value_type, multirate_integrator, sdc_corrections>     multirate_sdc;
     typedef explicit_sdc                                                time_integrator;
 
     // Surfaces/Volumes definitions
     typedef Glycocalyx<value_type,gpu_stokes_solver, time_integrator>   glycocalyx_surface;
     typedef HeartPump<value_type, gpu_stokes_solver, time_integrator>   heart_pump_surface;
     typedef Swarm<value_type, fmm_stokes_solver, time_integrator>       swarm_surface;
-    typedef ParticleMarkers<heart_pump_surface,forward_euler>           tracers_type;
+    typedef ParticleMarkers<heart_pump_surface,adams_bashforth>         tracers_type;
 
     // VTK types and utilities
     typedef vtkSurfaceStorage<glycocalyx_surface, vtkFloatArray>        glycocalyx_vtk_storage;
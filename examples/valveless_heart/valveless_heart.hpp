@@ -106,6 +106,7 @@ class HeartPump : public Surface<HeartPump<_value_type, fluid_solver, time_integ
         void setTracers(tracers_type &tracers, size_t num_rings)
         {
             m_geometry.init(tracers.particles(),num_rings);
+            tracers.reset();
 //             value_type T[3] = {0,0,.15};
 //             m_geometry.applyTranslation(tracers.particles(),T);
         }
@@ -0,0 +1,162 @@
+#ifndef DUAL_HPP
+#define DUAL_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+
+/**
+ * \brief Dual number a + b*e, e*e = 0, for forward mode automatic differentiation.
+ *
+ *  Evaluating a function on Dual(x,w) gives Dual(F(x),F'(x)*w).  The value and the derivative are
+ *  stored next to each other with no other members, so an array of duals is a contiguous array of
+ *  2*N scalars and the arithmetic below is plain elementwise code the compiler can vectorize.
+ *
+ *  Kernels become differentiable by templating them on the scalar type and calling the math
+ *  functions unqualified after a using declaration, e.g. "using std::sqrt; sqrt(r2)".
+ **/
+template<typename T>
+struct Dual
+{
+    T value;
+    T derivative;
+
+    Dual() : value(0), derivative(0) {}
+    Dual(const T &v) : value(v), derivative(0) {}
+    Dual(const T &v, const T &d) : value(v), derivative(d) {}
+
+    inline Dual &operator+=(const Dual &b) { value += b.value; derivative += b.derivative; return *this; }
+    inline Dual &operator-=(const Dual &b) { value -= b.value; derivative -= b.derivative; return *this; }
+    inline Dual &operator*=(const Dual &b)
+    {
+        derivative = derivative * b.value + value * b.derivative;
+        value *= b.value;
+        return *this;
+    }
+    inline Dual &operator/=(const Dual &b)
+    {
+        T inv = T(1) / b.value;
+        value *= inv;
+        derivative = (derivative - value * b.derivative) * inv;
+        return *this;
+    }
+    inline Dual &operator+=(const T &b) { value += b; return *this; }
+    inline Dual &operator-=(const T &b) { value -= b; return *this; }
+    inline Dual &operator*=(const T &b) { value *= b; derivative *= b; return *this; }
+    inline Dual &operator/=(const T &b) { T inv = T(1) / b; value *= inv; derivative *= inv; return *this; }
+};
+
+/** \internal
+ * Non deduced context for the scalar argument of mixed operations, so that double literals
+ * mix with Dual<float>.
+ */
+template<typename T>
+struct dual_scalar
+{
+    typedef T type;
+};
+
+template<typename T> inline Dual<T> operator+(const Dual<T> &a) { return a; }
+template<typename T> inline Dual<T> operator-(const Dual<T> &a) { return Dual<T>(-a.value, -a.derivative); }
+
+template<typename T> inline Dual<T> operator+(Dual<T> a, const Dual<T> &b) { return a += b; }
+template<typename T> inline Dual<T> operator-(Dual<T> a, const Dual<T> &b) { return a -= b; }
+template<typename T> inline Dual<T> operator*(Dual<T> a, const Dual<T> &b) { return a *= b; }
+template<typename T> inline Dual<T> operator/(Dual<T> a, const Dual<T> &b) { return a /= b; }
+
+template<typename T> inline Dual<T> operator+(Dual<T> a, typename dual_scalar<T>::type b) { return a += b; }
+template<typename T> inline Dual<T> operator-(Dual<T> a, typename dual_scalar<T>::type b) { return a -= b; }
+template<typename T> inline Dual<T> operator*(Dual<T> a, typename dual_scalar<T>::type b) { return a *= b; }
+template<typename T> inline Dual<T> operator/(Dual<T> a, typename dual_scalar<T>::type b) { return a /= b; }
+
+template<typename T> inline Dual<T> operator+(typename dual_scalar<T>::type a, const Dual<T> &b) { return Dual<T>(a + b.value, b.derivative); }
+template<typename T> inline Dual<T> operator-(typename dual_scalar<T>::type a, const Dual<T> &b) { return Dual<T>(a - b.value, -b.derivative); }
+template<typename T> inline Dual<T> operator*(typename dual_scalar<T>::type a, const Dual<T> &b) { return Dual<T>(a * b.value, a * b.derivative); }
+template<typename T> inline Dual<T> operator/(typename dual_scalar<T>::type a, const Dual<T> &b)
+{
+    T inv = T(1) / b.value;
+    T v = a * inv;
+    return Dual<T>(v, -v * b.derivative * inv);
+}
+
+/// Comparisons only look at the value part
+#define DUAL_COMPARISON(op) \
+    template<typename T> inline bool operator op(const Dual<T> &a, const Dual<T> &b) { return a.value op b.value; } \
+    template<typename T> inline bool operator op(const Dual<T> &a, typename dual_scalar<T>::type b) { return a.value op b; } \
+    template<typename T> inline bool operator op(typename dual_scalar<T>::type a, const Dual<T> &b) { return a op b.value; }
+
+DUAL_COMPARISON(==)
+DUAL_COMPARISON(!=)
+DUAL_COMPARISON(<)
+DUAL_COMPARISON(>)
+DUAL_COMPARISON(<=)
+DUAL_COMPARISON(>=)
+
+#undef DUAL_COMPARISON
+
+template<typename T>
+inline Dual<T> sqrt(const Dual<T> &a)
+{
+    T s = std::sqrt(a.value);
+    return Dual<T>(s, a.derivative / (T(2) * s));
+}
+
+template<typename T>
+inline Dual<T> exp(const Dual<T> &a)
+{
+    T e = std::exp(a.value);
+    return Dual<T>(e, e * a.derivative);
+}
+
+template<typename T>
+inline Dual<T> log(const Dual<T> &a)
+{
+    return Dual<T>(std::log(a.value), a.derivative / a.value);
+}
+
+template<typename T>
+inline Dual<T> sin(const Dual<T> &a)
+{
+    return Dual<T>(std::sin(a.value), std::cos(a.value) * a.derivative);
+}
+
+template<typename T>
+inline Dual<T> cos(const Dual<T> &a)
+{
+    return Dual<T>(std::cos(a.value), -std::sin(a.value) * a.derivative);
+}
+
+template<typename T>
+inline Dual<T> pow(const Dual<T> &a, typename dual_scalar<T>::type p)
+{
+    T v = std::pow(a.value, p);
+    return Dual<T>(v, p * std::pow(a.value, p - 1) * a.derivative);
+}
+
+template<typename T>
+inline Dual<T> fabs(const Dual<T> &a)
+{
+    return a.value < 0 ? -a : a;
+}
+
+template<typename T>
+inline Dual<T> abs(const Dual<T> &a)
+{
+    return fabs(a);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef DUAL_DIRECTIONAL_DERIVATIVE_HPP
+#define DUAL_DIRECTIONAL_DERIVATIVE_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+
+#include "math/autodiff/dual.hpp"
+
+/**
+ * \brief Exact directional derivative F'(x)*w computed in forward mode.
+ *   Drop in replacement of directional_derivative for InexactNewtonMethod.  The nonlinear
+ *   function must be templated on its scalar type, F(const T *x, T *Fx), so it can be
+ *   evaluated on Dual<value_type>.  One dual evaluation costs about twice a real one and there
+ *   is no difference increment to tune.
+ *
+ * \param F Non-linear function.
+ * \param x Point.
+ * \param f0 F(x), unused.  Kept for interface compatibility.
+ * \param workspace Unused, workspace_size() is 0.  The dual arguments and values are not
+ *   scalars, so they are allocated here, once per Newton solve.
+ **/
+template<typename operator_type, typename value_type>
+struct dual_directional_derivative
+{
+    typedef Dual<value_type> dual_type;
+
+    operator_type &m_F;
+    const value_type *m_x;
+    size_t m_system_size;
+    std::vector<dual_type> m_duals;     //< Arguments followed by values
+
+    dual_directional_derivative ( operator_type &F, const value_type *x, const value_type *, size_t system_size, value_type * = 0 ) :
+        m_F ( F ), m_x ( x ), m_system_size ( system_size ), m_duals ( 2 * system_size ) {}
+
+    static inline size_t workspace_size ( size_t ) { return 0; }
+
+    inline void operator() ( const value_type *w, value_type *DF )
+    {
+        dual_type *xd = &m_duals[0];
+        dual_type *fd = xd + m_system_size;
+        for ( size_t i = 0; i < m_system_size; ++i )
+        {
+            xd[i].value = m_x[i];
+            xd[i].derivative = w[i];
+            fd[i] = dual_type();
+        }
+        m_F ( xd, fd );
+        for ( size_t i = 0; i < m_system_size; ++i )
+            DF[i] = fd[i].derivative;
+    }
+};
+
+#endif
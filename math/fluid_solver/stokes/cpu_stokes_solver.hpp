@@ -32,29 +32,41 @@ class CpuStokesSolver
         value_type      m_delta;
         size_t          m_num_sources;
         bool m_images;
+        value_type      m_accuracy;
+        std::vector<float> m_single[4];     //< Targets, velocities, sources and forces in single precision
 
     public:    
         idx_vector      col_ptr;
         idx_vector      col_idx;
 
     public:
-        CpuStokesSolver(size_t num_sources) : m_num_sources(num_sources) {}
+        CpuStokesSolver(size_t num_sources) : m_num_sources(num_sources), m_accuracy(0) {}
         
-        inline void operator() ( value_type t, const value_type *x, value_type *v, const  value_type *f)
+        /**
+         * \brief Direct sum.  Templated on the array type so velocities can be differentiated
+         *  with respect to positions and forces using Dual numbers.
+         **/
+        template<typename T>
+        inline void operator() ( value_type t, const T *x, T *v, const T *f)
         {
             operator() ( t, x, v, x, f, m_num_sources );
         }
 
+        template<typename T>
+        inline void operator() ( value_type, const T *x, T *v, const T *y, const T *f, size_t num_targets )
+        {
+            directSum ( x, v, y, f, num_targets, m_delta );
+        }
+
+        /**
+         * \brief Direct sum, in single precision when the requested accuracy allows it.
+         **/
         inline void operator() ( value_type, const value_type *x, value_type *v, const value_type *y, const value_type *f, size_t num_targets )
         {
-            size_t size_targets = 3 * num_targets;
-            size_t size_sources = 3 * m_num_sources;
-            std::fill(v,v+size_targets,0.0);
-            #pragma omp parallel for shared(x,v,y,f)
-            for ( size_t i = 0; i < size_targets; i += 3 )
-                for ( size_t j = 0; j < size_sources; j += 3 )
-                    computeStokeslet( &x[i], &v[i], &y[j], &f[j], m_delta );
-            size_t idx = 0;
+            if ( sizeof(value_type) > sizeof(float) && m_accuracy >= value_type(1e-5) )
+                singlePrecisionSum ( x, v, y, f, num_targets );
+            else
+                directSum ( x, v, y, f, num_targets, m_delta );
         }
 
         inline void Implicit( value_type t, const value_type *x, value_type *v, const value_type *f )
@@ -124,6 +136,15 @@ class CpuStokesSolver
         }
 
         
+        /**
+         * \brief 3x3 interaction block between a target and a source particle, v_target += S*f_source.
+         *  Used to assemble block preconditioners.
+         **/
+        inline void block ( const value_type *target, const value_type *source, value_type *S )
+        {
+            computeStokesletTensor ( target, source, S, m_delta );
+        }
+
         void generateSequence(std::vector<size_t> &seq, size_t start)
         {
             for(size_t k = 0; k != seq.size(); ++k)
@@ -132,6 +153,37 @@ class CpuStokesSolver
       
       void setDelta(value_type delta) { m_delta = delta; }
       void withImages(bool images) { m_images = images; }
+
+      /**
+       * \brief Relative accuracy needed by the next direct sums.  From 1e-5 up the sum runs in
+       *  single precision, 0 (default) always uses value_type.
+       **/
+      void setAccuracy(value_type tol) { m_accuracy = tol; }
+
+    private:
+        template<typename T, typename real_type>
+        inline void directSum ( const T *x, T *v, const T *y, const T *f, size_t num_targets, real_type delta )
+        {
+            size_t size_targets = 3 * num_targets;
+            size_t size_sources = 3 * m_num_sources;
+            std::fill(v,v+size_targets,T(0));
+            #pragma omp parallel for shared(x,v,y,f)
+            for ( size_t i = 0; i < size_targets; i += 3 )
+                for ( size_t j = 0; j < size_sources; j += 3 )
+                    computeStokeslet( &x[i], &v[i], &y[j], &f[j], delta );
+        }
+
+        void singlePrecisionSum ( const value_type *x, value_type *v, const value_type *y, const value_type *f, size_t num_targets )
+        {
+            size_t size_targets = 3 * num_targets;
+            size_t size_sources = 3 * m_num_sources;
+            m_single[0].assign(x, x + size_targets);
+            m_single[1].resize(size_targets);
+            m_single[2].assign(y, y + size_sources);
+            m_single[3].assign(f, f + size_sources);
+            directSum ( &m_single[0][0], &m_single[1][0], &m_single[2][0], &m_single[3][0], num_targets, float(m_delta) );
+            std::copy(m_single[1].begin(), m_single[1].end(), v);
+        }
 };
 
 
@@ -19,6 +19,8 @@
 ****************************************************************************/
 
 #include <vector>
+#include <cmath>
+#include <algorithm>
 #include "cpu_stokes_solver.hpp"
 
 extern "C"
@@ -39,6 +41,7 @@ class HybridFmmStokesSolver
         value_type m_delta;
         bool m_initialized;
         bool m_images;
+        int m_precision;
 
     public:
         HybridFmmStokesSolver(size_t num_particles)
@@ -49,7 +52,8 @@ class HybridFmmStokesSolver
                 m_fields(num_particles),
                 m_potentials(num_particles),
                 m_index(num_particles),
-                m_initialized(false)
+                m_initialized(false),
+                m_precision(precision)
         {
             octree.maxBodiesPerNode = 2;
             octree.numParticles = num_particles;
@@ -127,7 +131,7 @@ class HybridFmmStokesSolver
             if (!m_initialized)
             {
                 logger.startTimer("CreateOctree");
-                CreateOctree(m_num_particles, precision, 255.9999, 0);
+                CreateOctree(m_num_particles, m_precision, 255.9999, 0);
                 logger.stopTimer("CreateOctree");
                 m_initialized = true;
             }
@@ -135,7 +139,7 @@ class HybridFmmStokesSolver
             {
                 logger.startTimer("UpdateOctree");
 //                 if (ReSort(octree.root, octree.rootInfo))
-                    RebuildTree(m_num_particles, precision, 255.9999, 0);
+                    RebuildTree(m_num_particles, m_precision, 255.9999, 0);
                 logger.stopTimer("UpdateOctree");
             }
 //             print_particle_index();
@@ -161,6 +165,17 @@ class HybridFmmStokesSolver
 
         void setDelta(value_type delta) { m_delta = delta; }
 
+        /**
+         * \brief Expansion order for the requested accuracy, about one term per digit and at
+         *  most the precision template parameter, which also sizes the expansions.  0 restores it.
+         **/
+        void setAccuracy(value_type tol)
+        {
+            m_precision = precision;
+            if(tol > 0)
+                m_precision = std::max(2, std::min(precision, int(std::ceil(-std::log10(tol)))));
+        }
+
         void allPairs()
         {
             std::vector<value_type> velocity(3*m_num_particles, 0.0);
@@ -28,17 +28,18 @@
  * @param force force vector
  * @param delta regularization parameter
  **/
-template<typename value_type>
-inline void computeStokeslet(const value_type *target, value_type *velocity, const value_type *source, const value_type *force, value_type delta)
+template<typename value_type, typename real_type>
+inline void computeStokeslet(const value_type *target, value_type *velocity, const value_type *source, const value_type *force, real_type delta)
 {
+    using std::sqrt;
     value_type dx[3] = {target[0] - source[0], target[1] - source[1], target[2] - source[2]};
 
     value_type r2 = dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2];
-    value_type d2 = delta * delta;
+    real_type d2 = delta * delta;
     value_type R1 = r2 + d2;
     value_type R2 = R1 + d2;
     value_type invR = 1.0 / R1;
-    value_type H = std::sqrt(invR) * invR * 0.039788735772974;
+    value_type H = sqrt(invR) * invR * 0.039788735772974;
 
     value_type fdx = (force[0] * dx[0] + force[1] * dx[1] + force[2] * dx[2]);
 
@@ -48,6 +49,32 @@ inline void computeStokeslet(const value_type *target, value_type *velocity, con
 }
 
 
+/**
+ * @brief Compute the 3x3 regularized stokeslet tensor S such that velocity = S*force.
+ *
+ * @param target position of velocity
+ * @param source position of the force
+ * @param S row major 3x3 tensor
+ * @param delta regularization parameter
+ **/
+template<typename value_type>
+inline void computeStokesletTensor(const value_type *target, const value_type *source, value_type *S, value_type delta)
+{
+    value_type dx[3] = {target[0] - source[0], target[1] - source[1], target[2] - source[2]};
+
+    value_type r2 = dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2];
+    value_type d2 = delta * delta;
+    value_type R1 = r2 + d2;
+    value_type R2 = R1 + d2;
+    value_type invR = 1.0 / R1;
+    value_type H = std::sqrt(invR) * invR * 0.039788735772974;
+
+    for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < 3; ++j)
+            S[3 * i + j] = H * ((i == j ? R2 : value_type(0)) + dx[i] * dx[j]);
+}
+
+
 /**
  * @brief Update the velocity at target position due to a force at source position using a regularized stokeslet.
  *
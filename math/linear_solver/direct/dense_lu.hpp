@@ -0,0 +1,112 @@
+#ifndef DENSE_LU_HPP
+#define DENSE_LU_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<vector>
+#include<algorithm>
+#include<stdexcept>
+
+/**
+ * \brief Dense LU factorization with partial pivoting, P*A = L*U.
+ *  The factors are stored in place in a row major array.  Meant for the small
+ *  blocks used by preconditioners and coarse solves.
+ **/
+template<typename value_type>
+class DenseLU
+{
+    private:
+        size_t                  m_size;
+        std::vector<value_type> m_lu;
+        std::vector<size_t>     m_pivots;
+
+    public:
+        DenseLU() : m_size(0) {}
+
+        inline size_t size() const { return m_size; }
+        inline value_type &operator()(size_t i, size_t j) { return m_lu[i * m_size + j]; }
+        inline const value_type &operator()(size_t i, size_t j) const { return m_lu[i * m_size + j]; }
+
+        /**
+         * \brief Resize and clear the matrix.  Fill it with operator()(i,j) before calling factor().
+         **/
+        inline void resize(size_t n)
+        {
+            m_size = n;
+            m_lu.assign(n * n, value_type(0));
+            m_pivots.resize(n);
+        }
+
+        /**
+         * \brief Factor the matrix in place.
+         **/
+        void factor()
+        {
+            size_t n = m_size;
+            for(size_t k = 0; k < n; ++k)
+            {
+                size_t p = k;
+                value_type max = std::fabs((*this)(k, k));
+                for(size_t i = k + 1; i < n; ++i)
+                    if(std::fabs((*this)(i, k)) > max)
+                    {
+                        max = std::fabs((*this)(i, k));
+                        p = i;
+                    }
+                if(max == value_type(0))
+                    throw std::domain_error("DenseLU::factor(): Singular matrix");
+                m_pivots[k] = p;
+                if(p != k)
+                    std::swap_ranges(&m_lu[k * n], &m_lu[k * n] + n, &m_lu[p * n]);
+                value_type inv_pivot = value_type(1) / (*this)(k, k);
+                for(size_t i = k + 1; i < n; ++i)
+                {
+                    value_type l = (*this)(i, k) *= inv_pivot;
+                    for(size_t j = k + 1; j < n; ++j)
+                        (*this)(i, j) -= l * (*this)(k, j);
+                }
+            }
+        }
+
+        /**
+         * \brief Solves A*x = b using the factors.  b is overwritten by the solution.
+         **/
+        void solve(value_type *b) const
+        {
+            size_t n = m_size;
+            for(size_t k = 0; k < n; ++k)
+                if(m_pivots[k] != k)
+                    std::swap(b[k], b[m_pivots[k]]);
+            for(size_t i = 1; i < n; ++i)
+            {
+                value_type s = b[i];
+                for(size_t j = 0; j < i; ++j)
+                    s -= (*this)(i, j) * b[j];
+                b[i] = s;
+            }
+            for(size_t i = n; i-- > 0;)
+            {
+                value_type s = b[i];
+                for(size_t j = i + 1; j < n; ++j)
+                    s -= (*this)(i, j) * b[j];
+                b[i] = s / (*this)(i, i);
+            }
+        }
+};
+
+#endif
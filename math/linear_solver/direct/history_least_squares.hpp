@@ -0,0 +1,119 @@
+#ifndef HISTORY_LEAST_SQUARES_HPP
+#define HISTORY_LEAST_SQUARES_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<vector>
+
+#include "utils/ring_buffer.hpp"
+
+/**
+ * \brief Solves min |b - A*c| where the columns of A are the vectors of a RingBuffer, with a
+ *  modified Gram-Schmidt QR factorization.
+ *
+ *  The newest vectors are taken first.  A vector whose component orthogonal to the newer ones is
+ *  below tol times its norm is skipped, so nearly dependent history is dropped oldest first.
+ *  After solve(), column(j) is the RingBuffer index of the j-th vector used and coefficient(j)
+ *  its coefficient.
+ **/
+template<typename value_type>
+class HistoryLeastSquares
+{
+    private:
+        size_t                  m_vector_size;
+        size_t                  m_max_columns;
+        std::vector<value_type> m_q;        //< Orthonormal basis of the columns used
+        std::vector<value_type> m_R;
+        std::vector<value_type> m_c;
+        std::vector<size_t>     m_columns;
+
+    public:
+        HistoryLeastSquares(size_t max_columns, size_t vector_size) :
+                m_vector_size(vector_size),
+                m_max_columns(max_columns),
+                m_q(max_columns * vector_size),
+                m_R(max_columns * max_columns),
+                m_c(max_columns),
+                m_columns(max_columns)
+        {}
+
+        inline size_t column(size_t j) const { return m_columns[j]; }
+        inline value_type coefficient(size_t j) const { return m_c[j]; }
+
+        /**
+         * \brief Least squares fit of b by the vectors of A.
+         *
+         * \param A History, at most max_columns vectors of size vector_size.
+         * \param b Vector to fit.
+         * \param tol Relative tolerance below which a vector counts as dependent.
+         * \return Number of vectors used.
+         **/
+        size_t solve(const RingBuffer<value_type> &A, const value_type *b, value_type tol)
+        {
+            size_t N = m_vector_size, n = m_max_columns;
+            size_t m = 0;
+            for(size_t k = 0; k < A.size() && m < n; ++k)
+            {
+                value_type *q = &m_q[m * N];
+                std::copy(A[k], A[k] + N, q);
+                value_type a_norm = norm(q);
+                for(size_t j = 0; j < m; ++j)
+                {
+                    const value_type *qj = &m_q[j * N];
+                    value_type r = dot(qj, q);
+                    m_R[j * n + m] = r;
+                    for(size_t i = 0; i < N; ++i)
+                        q[i] -= r * qj[i];
+                }
+                value_type r = norm(q);
+                if(r <= tol * a_norm || r == value_type(0))
+                    continue;
+                m_R[m * n + m] = r;
+                for(size_t i = 0; i < N; ++i)
+                    q[i] /= r;
+                m_columns[m++] = k;
+            }
+
+            /// c = R^{-1}*Q^T*b
+            for(size_t j = 0; j < m; ++j)
+                m_c[j] = dot(&m_q[j * N], b);
+            for(size_t j = m; j-- > 0;)
+            {
+                for(size_t k = j + 1; k < m; ++k)
+                    m_c[j] -= m_R[j * n + k] * m_c[k];
+                m_c[j] /= m_R[j * n + j];
+            }
+            return m;
+        }
+
+    private:
+        inline value_type dot(const value_type *x, const value_type *y)
+        {
+            value_type s = value_type(0);
+            for(size_t i = 0; i < m_vector_size; ++i)
+                s += x[i] * y[i];
+            return s;
+        }
+
+        inline value_type norm(const value_type *x)
+        {
+            return std::sqrt(dot(x, x));
+        }
+};
+
+#endif
@@ -18,9 +18,11 @@
 ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****************************************************************************/
 #include<algorithm>
+#include<limits>
 
 #include "krylov_storage.hpp"
 #include "krylov_base.hpp"
+#include "math/linear_solver/preconditioner/identity_preconditioner.hpp"
 
 template<typename value_type, int krylov_space_maximum_dimension>
 class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalResidualMethod<value_type, krylov_space_maximum_dimension> >
@@ -47,6 +49,7 @@ class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalRes
         inline value_type &g(size_t i) { return m_storage.g(i); }
         inline value_type *g() { return m_storage.g(); }
         inline value_type *v(size_t i) { return m_storage.v(i); }
+        inline value_type *z() { return m_storage.z(); }
         inline size_t system_size() { return m_system_size; }
 
         /**
@@ -60,12 +63,38 @@ class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalRes
         **/
         template<typename operator_type, typename vector_type>
         inline value_type operator()(operator_type &F, const value_type *b, value_type *x, value_type errtol = 1e-6, std::map<std::string, vector_type> *stats = 0)
+        {
+            IdentityPreconditioner<value_type> M(m_system_size);
+            return operator()(F, M, b, x, errtol, stats);
+        }
+
+        /**
+        * \brief Right preconditioned Gneralized Minimal Residual Method.  Solves F(M^{-1}y) = b and sets x = M^{-1}y.
+        *   The residual minimized is the residual of the original system.
+        *
+        * \param F This is a linear operator on x.
+        * \param M Preconditioner, M(r,z) computes z = M^{-1}r.
+        * \param b Right hand side vector of the linear system.
+        * \param x Initial guess and solution vector
+        * \param stats This is an optional vector to collect statistics of the method.  Defaults to 0.
+        * \return norm of the residual
+        **/
+        template<typename operator_type, typename preconditioner_type, typename vector_type>
+        inline value_type operator()(operator_type &F, preconditioner_type &M, const value_type *b, value_type *x, value_type errtol = 1e-6, std::map<std::string, vector_type> *stats = 0)
         {
             /// Compute the residual
             F(x, residual());
             std::transform(b, b + m_system_size, residual(), residual(), std::minus<value_type>());
             value_type rho = this->norm(residual());
-            errtol *= this->norm(b);
+            value_type b_norm = this->norm(b);
+            errtol *= b_norm;
+            /// An initial guess worse than zero is discarded
+            if(rho > b_norm)
+            {
+                std::fill(x, x + m_system_size, value_type(0));
+                std::copy(b, b + m_system_size, residual());
+                rho = b_norm;
+            }
             if(stats)
             {
                 std::map<std::string, vector_type> &s = *stats;
@@ -93,8 +122,9 @@ class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalRes
             int k;
             for(k = 0; k < k_max && rho > errtol; ++k)
             {
-                /// Evaluate linear operator
-                F(v(k), v(k + 1));
+                /// Evaluate the preconditioned linear operator
+                M(v(k), z());
+                F(z(), v(k + 1));
 
                 /// Apply Arnoldi's method with modified Gram-Schmidt orthogonalization to the colums of v
                 value_type ld = this->arnoldi(k);
@@ -107,7 +137,7 @@ class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalRes
                 this->apply_rotation(H(k, k), ld, c(k), s(k));
                 this->apply_rotation(g(k), g(k + 1), c(k), s(k));
 
-                assert(ld < 1e-10 || !"rotation failed: Lower diagonal is non-zero");
+                assert(std::fabs(ld) < 1e-10 || std::fabs(ld) <= 1e3 * std::numeric_limits<value_type>::epsilon() * std::fabs(H(k, k)) || !"rotation failed: Lower diagonal is non-zero");
 
                 ///  The norm of the residual is the last entry in g
                 rho = std::fabs(g(k + 1));
@@ -128,12 +158,16 @@ class GeneralizedMinimalResidualMethod : public KrylovBase<GeneralizedMinimalRes
             /// Solve the least square problem by solving the upper triangular linear system
             this->back_solve(k);
             
-            /// Update the solution
+            /// Update the solution, x = x + M^{-1}*V*g
+            std::fill(residual(), residual() + m_system_size, value_type(0));
             for(int i = 0; i < k; i++)
             {
                 for(size_t j = 0; j < m_system_size; ++j)
-                    x[j] += g(i)*v(i)[j];
+                    residual(j) += g(i)*v(i)[j];
             }
+            M(residual(), z());
+            for(size_t j = 0; j < m_system_size; ++j)
+                x[j] += z()[j];
 
             return rho;
         }
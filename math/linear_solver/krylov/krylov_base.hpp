@@ -163,7 +163,7 @@ class KrylovBase
             value_type s = value_type ( 0 );
             for ( size_t i = 0; i < system_size; ++i )
                 s += x[i]*y[i];
-            assert(!isnan(s));
+            assert(!std::isnan(s));
             return s;
         }
         
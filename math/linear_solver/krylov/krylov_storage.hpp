@@ -30,6 +30,7 @@ struct krylov_arrays
     T G[krylov_space+1];
     T *V;
     T *R;
+    T *Z;
 };
 
 /** \internal
@@ -55,17 +56,20 @@ class krylov_storage
         {
             m_data.V = new T[system_size* ( krylov_space+1 ) ];
             m_data.R = new T[system_size];
+            m_data.Z = new T[system_size];
             std::fill(m_data.H,m_data.H+krylov_space* ( krylov_space+1 ) /2,0.0);
             std::fill(m_data.C,m_data.C+krylov_space+1,0.0);
             std::fill(m_data.S,m_data.S+krylov_space+1,0.0);
             std::fill(m_data.G,m_data.G+krylov_space+1,0.0);
             std::fill(m_data.V,m_data.V+system_size* ( krylov_space+1 ),0.0);
             std::fill(m_data.R,m_data.R+system_size,0.0);
+            std::fill(m_data.Z,m_data.Z+system_size,0.0);
         }
         ~krylov_storage()
         {
             delete [] m_data.V;
             delete [] m_data.R;
+            delete [] m_data.Z;
         }
         inline void swap ( krylov_storage& other ) { std::swap ( m_data,other.m_data ); }
         inline T &H ( size_t i, size_t j ) { return * ( m_data.H + i*krylov_space+j-i*(i+1)/2 ); }
@@ -73,6 +77,7 @@ class krylov_storage
         inline T *residual () { return m_data.R; }
         inline T &residual ( size_t i ) { return * ( m_data.R + i ); }
         inline T *v ( size_t i ) { return m_data.V + i*m_system_size; }
+        inline T *z () { return m_data.Z; }
         inline T &c ( size_t i ) { return * ( m_data.C + i ); }
         inline T &s ( size_t i ) { return * ( m_data.S + i ); }
         inline T &g ( size_t i ) { return * ( m_data.G + i ); }
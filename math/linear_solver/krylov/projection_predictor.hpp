@@ -0,0 +1,84 @@
+#ifndef PROJECTION_PREDICTOR_HPP
+#define PROJECTION_PREDICTOR_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<limits>
+#include<vector>
+#include<algorithm>
+
+#include "utils/ring_buffer.hpp"
+#include "math/linear_solver/direct/history_least_squares.hpp"
+
+/**
+ * \brief Initial guess for a sequence of linear solves A*x = b with slowly changing A.
+ *
+ *  Keeps the last right hand sides b_i and solutions x_i.  The new right hand side is projected
+ *  onto the span of the b_i, b ~ sum c_i*b_i in the least squares sense, and the initial guess is
+ *  x = sum c_i*x_i.  For a fixed A this is the exact solution on that subspace.
+ *
+ *  It pays off for sequences of accurate solves with nearly parallel right hand sides.  The pairs
+ *  are only as consistent as the solves that produced them, so loosely solved systems (e.g. the
+ *  early Newton steps with a large forcing term) give poor predictions.
+ **/
+template<typename value_type>
+class ProjectionPredictor
+{
+    private:
+        size_t                          m_size;
+        RingBuffer<value_type>          m_rhs;
+        RingBuffer<value_type>          m_solutions;
+        HistoryLeastSquares<value_type> m_least_squares;
+
+    public:
+        ProjectionPredictor(size_t size, size_t max_vectors = 5) :
+                m_size(size),
+                m_rhs(max_vectors, size),
+                m_solutions(max_vectors, size),
+                m_least_squares(max_vectors, size)
+        {}
+
+        inline void clear() { m_rhs.clear(); m_solutions.clear(); }
+
+        /**
+         * \brief Computes the initial guess x for the right hand side b.  Sets x = 0 if there is no history.
+         **/
+        void predict(const value_type *b, value_type *x)
+        {
+            size_t m = m_least_squares.solve(m_rhs, b, std::sqrt(std::numeric_limits<value_type>::epsilon()));
+            std::fill(x, x + m_size, value_type(0));
+            for(size_t j = 0; j < m; ++j)
+            {
+                const value_type *xj = m_solutions[m_least_squares.column(j)];
+                value_type c = m_least_squares.coefficient(j);
+                for(size_t i = 0; i < m_size; ++i)
+                    x[i] += c * xj[i];
+            }
+        }
+
+        /**
+         * \brief Records the solution x of the system with right hand side b.
+         **/
+        void record(const value_type *b, const value_type *x)
+        {
+            m_rhs.push(0, b);
+            m_solutions.push(0, x);
+        }
+};
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef BLOCK_JACOBI_PRECONDITIONER_HPP
+#define BLOCK_JACOBI_PRECONDITIONER_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<vector>
+#include<map>
+#include<string>
+#include<algorithm>
+#include<stdexcept>
+
+#include "math/linear_solver/direct/dense_lu.hpp"
+
+/**
+ * \brief Block Jacobi preconditioner with one dense block per body.
+ *
+ *  Particles of a body are stored contiguously, body b owns particles body_ptr[b] to body_ptr[b+1]-1.
+ *  The self interaction block of every body is assembled with a kernel and factored with a dense LU.
+ *  The kernel is any object with a method block(target,source,S) returning the 3x3 interaction
+ *  tensor S between two particles (see CpuStokesSolver::block).
+ *
+ *  Factorizations are kept between calls to update().  A body is refactored only when its shape,
+ *  measured relative to its centroid, changed by more than the refactor tolerance since its last
+ *  factorization.  Pure translations never trigger a refactorization.
+ *
+ *  A singular block, e.g. from coincident particles, is left out: the preconditioner is the
+ *  identity on that body, see singular(), and the block is factored again on the next update().
+ **/
+template<typename value_type>
+class BlockJacobiPreconditioner
+{
+    private:
+        size_t                                  m_system_size;
+        std::vector<size_t>                     m_body_ptr;
+        std::vector<DenseLU<value_type> >       m_blocks;
+        std::vector<value_type>                 m_reference;
+        std::vector<char>                       m_factored;   //< Not vector<bool>, set concurrently by update()
+        std::vector<char>                       m_singular;
+        value_type                              m_tolerance;
+
+    public:
+        BlockJacobiPreconditioner(size_t system_size) :
+                m_system_size(system_size),
+                m_reference(system_size),
+                m_tolerance(value_type(1e-2))
+        {
+            setBodies(1, system_size / 3);
+        }
+
+        inline size_t system_size() { return m_system_size; }
+        inline size_t num_bodies() { return m_body_ptr.size() - 1; }
+        inline void setRefactorTolerance(value_type tol) { m_tolerance = tol; }
+
+        /**
+         * \brief True if the block of body b could not be factored by the last update().
+         **/
+        inline bool singular(size_t b) const { return m_singular[b]; }
+
+        /**
+         * \brief Set the body partition.
+         *
+         * \param body_ptr Particle offsets of each body, size num_bodies+1.
+         **/
+        void setBodies(const std::vector<size_t> &body_ptr)
+        {
+            m_body_ptr = body_ptr;
+            m_blocks.resize(num_bodies());
+            m_factored.assign(num_bodies(), false);
+            m_singular.assign(num_bodies(), false);
+        }
+
+        /**
+         * \brief Set a partition of num_bodies bodies with the same number of particles.
+         **/
+        void setBodies(size_t num_bodies, size_t particles_per_body)
+        {
+            std::vector<size_t> body_ptr(num_bodies + 1);
+            for(size_t b = 0; b <= num_bodies; ++b)
+                body_ptr[b] = b * particles_per_body;
+            setBodies(body_ptr);
+        }
+
+        /**
+         * \brief Refactor the blocks of the bodies that deformed since their last factorization.
+         *
+         * \param K Block kernel.
+         * \param x Particle positions.
+         * \param stats Optional map to collect statistics.  Defaults to 0.
+         * \return number of refactored blocks.
+         **/
+        template<typename kernel_type>
+        size_t update(kernel_type &K, const value_type *x, std::map<std::string, std::vector<value_type> > *stats = 0)
+        {
+            size_t refactored = 0, singular = 0;
+            #pragma omp parallel for schedule(dynamic) reduction(+:refactored,singular)
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                if(m_factored[b] && deformation(b, x) <= m_tolerance)
+                    continue;
+                /// An exception can not leave the parallel region
+                try
+                {
+                    factor(K, b, x);
+                    m_singular[b] = false;
+                    ++refactored;
+                }
+                catch(std::domain_error &)
+                {
+                    m_singular[b] = true;
+                    ++singular;
+                }
+            }
+            if(stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *stats;
+                s["block_jacobi_refactorizations"].push_back(refactored);
+                s["block_jacobi_singular"].push_back(singular);
+            }
+            return refactored;
+        }
+
+        /**
+         * \brief Applies the preconditioner, z = M^{-1}*r.
+         **/
+        inline void operator()(const value_type *r, value_type *z)
+        {
+            #pragma omp parallel for
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                size_t begin = 3 * m_body_ptr[b], end = 3 * m_body_ptr[b + 1];
+                std::copy(r + begin, r + end, z + begin);
+                if(!m_singular[b])
+                    m_blocks[b].solve(z + begin);
+            }
+        }
+
+    private:
+        template<typename kernel_type>
+        void factor(kernel_type &K, size_t b, const value_type *x)
+        {
+            size_t begin = m_body_ptr[b], end = m_body_ptr[b + 1];
+            size_t n = end - begin;
+            DenseLU<value_type> &LU = m_blocks[b];
+            LU.resize(3 * n);
+            value_type S[9];
+            for(size_t i = 0; i < n; ++i)
+                for(size_t j = 0; j < n; ++j)
+                {
+                    K.block(&x[3 * (begin + i)], &x[3 * (begin + j)], S);
+                    for(int k = 0; k < 3; ++k)
+                        for(int l = 0; l < 3; ++l)
+                            LU(3 * i + k, 3 * j + l) = S[3 * k + l];
+                }
+            LU.factor();
+            std::copy(x + 3 * begin, x + 3 * end, &m_reference[3 * begin]);
+            m_factored[b] = true;
+        }
+
+        /**
+         * \brief Largest change of a particle position relative to the body centroid, scaled by the body radius.
+         **/
+        value_type deformation(size_t b, const value_type *x)
+        {
+            size_t begin = m_body_ptr[b], end = m_body_ptr[b + 1];
+            value_type c[3] = {0, 0, 0}, c0[3] = {0, 0, 0};
+            for(size_t i = begin; i < end; ++i)
+                for(int k = 0; k < 3; ++k)
+                {
+                    c[k] += x[3 * i + k];
+                    c0[k] += m_reference[3 * i + k];
+                }
+            value_type inv_n = value_type(1) / (end - begin);
+            for(int k = 0; k < 3; ++k)
+            {
+                c[k] *= inv_n;
+                c0[k] *= inv_n;
+            }
+            value_type max_change = 0, radius = 0;
+            for(size_t i = begin; i < end; ++i)
+            {
+                value_type change = 0, r = 0;
+                for(int k = 0; k < 3; ++k)
+                {
+                    value_type y0 = m_reference[3 * i + k] - c0[k];
+                    value_type d = (x[3 * i + k] - c[k]) - y0;
+                    change += d * d;
+                    r += y0 * y0;
+                }
+                max_change = std::max(max_change, change);
+                radius = std::max(radius, r);
+            }
+            if(radius == value_type(0))
+                return std::sqrt(max_change);
+            return std::sqrt(max_change / radius);
+        }
+};
+
+#endif
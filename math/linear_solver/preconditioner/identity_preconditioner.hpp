@@ -0,0 +1,41 @@
+#ifndef IDENTITY_PRECONDITIONER_HPP
+#define IDENTITY_PRECONDITIONER_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<algorithm>
+
+/**
+ * \brief Trivial preconditioner, z = r.
+ *
+ * Preconditioners are functors that apply the inverse of the preconditioning
+ * matrix, M(r,z) computes z = M^{-1}*r.
+ **/
+template<typename value_type>
+struct IdentityPreconditioner
+{
+    size_t m_system_size;
+
+    IdentityPreconditioner(size_t system_size) : m_system_size(system_size) {}
+
+    inline void operator()(const value_type *r, value_type *z)
+    {
+        std::copy(r, r + m_system_size, z);
+    }
+};
+
+#endif
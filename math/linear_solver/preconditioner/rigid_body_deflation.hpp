@@ -0,0 +1,208 @@
+#ifndef RIGID_BODY_DEFLATION_HPP
+#define RIGID_BODY_DEFLATION_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<map>
+#include<string>
+#include<algorithm>
+
+#include "math/linear_solver/direct/dense_lu.hpp"
+#include "math/linear_solver/preconditioner/block_jacobi_preconditioner.hpp"
+
+/**
+ * \brief Additive two-level preconditioner, M^{-1} = M_fine^{-1} + Z*E^{-1}*Z^T, with E = Z^T*A*Z.
+ *
+ *  The coarse space Z is spanned by the six rigid body modes (three translations and three rotations
+ *  about the centroid) of each body.  These are the modes that couple bodies over long range and are
+ *  responsible for the iteration counts growing with the number of bodies.
+ *
+ *  The coarse matrix is assembled from the same 3x3 block kernel as BlockJacobiPreconditioner and it
+ *  is rebuilt and refactored on every call to update().  Its size is 6*num_bodies.
+ *
+ * \param fine_preconditioner_type Fine level preconditioner.  Needs update(K,x,stats) and operator()(r,z).
+ **/
+template<typename value_type, typename fine_preconditioner_type = BlockJacobiPreconditioner<value_type> >
+class RigidBodyDeflation
+{
+    private:
+        size_t                      m_system_size;
+        fine_preconditioner_type    &m_fine;
+        std::vector<size_t>         m_body_ptr;
+        std::vector<value_type>     m_arms;         //< Particle positions relative to their body centroid
+        DenseLU<value_type>         m_coarse;
+        std::vector<value_type>     m_coarse_rhs;
+
+    public:
+        RigidBodyDeflation(size_t system_size, fine_preconditioner_type &fine) :
+                m_system_size(system_size),
+                m_fine(fine),
+                m_arms(system_size)
+        {
+            setBodies(1, system_size / 3);
+        }
+
+        inline size_t system_size() { return m_system_size; }
+        inline size_t num_bodies() { return m_body_ptr.size() - 1; }
+        inline fine_preconditioner_type &fine() { return m_fine; }
+
+        /**
+         * \brief Set the body partition.
+         *
+         * \param body_ptr Particle offsets of each body, size num_bodies+1.
+         **/
+        void setBodies(const std::vector<size_t> &body_ptr)
+        {
+            m_body_ptr = body_ptr;
+            m_coarse_rhs.resize(6 * num_bodies());
+        }
+
+        /**
+         * \brief Set a partition of num_bodies bodies with the same number of particles.
+         **/
+        void setBodies(size_t num_bodies, size_t particles_per_body)
+        {
+            std::vector<size_t> body_ptr(num_bodies + 1);
+            for(size_t b = 0; b <= num_bodies; ++b)
+                body_ptr[b] = b * particles_per_body;
+            setBodies(body_ptr);
+        }
+
+        /**
+         * \brief Update the fine preconditioner and rebuild the coarse matrix at the current positions.
+         *
+         * \param K Block kernel, K.block(target,source,S).
+         * \param x Particle positions.
+         * \param stats Optional map to collect statistics.  Defaults to 0.
+         **/
+        template<typename kernel_type>
+        void update(kernel_type &K, const value_type *x, std::map<std::string, std::vector<value_type> > *stats = 0)
+        {
+            m_fine.update(K, x, stats);
+
+            size_t coarse_size = 6 * num_bodies();
+            m_coarse.resize(coarse_size);
+
+            #pragma omp parallel for
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                value_type c[3] = {0, 0, 0};
+                for(size_t i = m_body_ptr[b]; i < m_body_ptr[b + 1]; ++i)
+                    for(int k = 0; k < 3; ++k)
+                        c[k] += x[3 * i + k];
+                for(int k = 0; k < 3; ++k)
+                    c[k] /= (m_body_ptr[b + 1] - m_body_ptr[b]);
+                for(size_t i = m_body_ptr[b]; i < m_body_ptr[b + 1]; ++i)
+                    for(int k = 0; k < 3; ++k)
+                        m_arms[3 * i + k] = x[3 * i + k] - c[k];
+            }
+
+            /// E(b,c) = sum_{i in b, j in c} Z_i^T * S(x_i,x_j) * Z_j
+            #pragma omp parallel for schedule(dynamic)
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                value_type S[9], Zi[18], Zj[18], SZ[18];
+                for(size_t i = m_body_ptr[b]; i < m_body_ptr[b + 1]; ++i)
+                {
+                    modes(i, Zi);
+                    for(size_t c = 0; c < num_bodies(); ++c)
+                        for(size_t j = m_body_ptr[c]; j < m_body_ptr[c + 1]; ++j)
+                        {
+                            modes(j, Zj);
+                            K.block(&x[3 * i], &x[3 * j], S);
+                            for(int r = 0; r < 3; ++r)
+                                for(int q = 0; q < 6; ++q)
+                                    SZ[6 * r + q] = S[3 * r] * Zj[q] + S[3 * r + 1] * Zj[6 + q] + S[3 * r + 2] * Zj[12 + q];
+                            for(int p = 0; p < 6; ++p)
+                                for(int q = 0; q < 6; ++q)
+                                    m_coarse(6 * b + p, 6 * c + q) += Zi[p] * SZ[q] + Zi[6 + p] * SZ[6 + q] + Zi[12 + p] * SZ[12 + q];
+                        }
+                }
+            }
+
+            /// Modes that vanish (e.g. rotations of a single particle body) are decoupled
+            for(size_t p = 0; p < coarse_size; ++p)
+                if(m_coarse(p, p) == value_type(0))
+                    m_coarse(p, p) = value_type(1);
+            m_coarse.factor();
+
+            if(stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *stats;
+                s["deflation_coarse_size"].push_back(coarse_size);
+            }
+        }
+
+        /**
+         * \brief Applies the preconditioner, z = M_fine^{-1}*r + Z*E^{-1}*Z^T*r.
+         **/
+        inline void operator()(const value_type *r, value_type *z)
+        {
+            /// Restriction, translation rows sum the residual and rotation rows sum the torques
+            #pragma omp parallel for
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                value_type *y = &m_coarse_rhs[6 * b];
+                std::fill(y, y + 6, value_type(0));
+                for(size_t i = m_body_ptr[b]; i < m_body_ptr[b + 1]; ++i)
+                {
+                    const value_type *ri = &r[3 * i], *a = &m_arms[3 * i];
+                    y[0] += ri[0];
+                    y[1] += ri[1];
+                    y[2] += ri[2];
+                    y[3] += a[1] * ri[2] - a[2] * ri[1];
+                    y[4] += a[2] * ri[0] - a[0] * ri[2];
+                    y[5] += a[0] * ri[1] - a[1] * ri[0];
+                }
+            }
+            m_coarse.solve(&m_coarse_rhs[0]);
+
+            m_fine(r, z);
+
+            /// Prolongation, z_i += U + W x a_i
+            #pragma omp parallel for
+            for(size_t b = 0; b < num_bodies(); ++b)
+            {
+                const value_type *U = &m_coarse_rhs[6 * b], *W = &m_coarse_rhs[6 * b + 3];
+                for(size_t i = m_body_ptr[b]; i < m_body_ptr[b + 1]; ++i)
+                {
+                    const value_type *a = &m_arms[3 * i];
+                    z[3 * i]     += U[0] + W[1] * a[2] - W[2] * a[1];
+                    z[3 * i + 1] += U[1] + W[2] * a[0] - W[0] * a[2];
+                    z[3 * i + 2] += U[2] + W[0] * a[1] - W[1] * a[0];
+                }
+            }
+        }
+
+    private:
+        /**
+         * \brief Row major 3x6 matrix of rigid body modes at particle i, [I | e_k x a_i].
+         **/
+        inline void modes(size_t i, value_type *Z)
+        {
+            const value_type *a = &m_arms[3 * i];
+            std::fill(Z, Z + 18, value_type(0));
+            Z[0] = Z[7] = Z[14] = value_type(1);
+            /// e_x x a = (0,-a_z,a_y), e_y x a = (a_z,0,-a_x), e_z x a = (-a_y,a_x,0)
+            Z[3] = 0;     Z[4] = a[2];  Z[5] = -a[1];
+            Z[9] = -a[2]; Z[10] = 0;    Z[11] = a[0];
+            Z[15] = a[1]; Z[16] = -a[0]; Z[17] = 0;
+        }
+};
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef ITERATIVE_REFINEMENT_HPP
+#define ITERATIVE_REFINEMENT_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<limits>
+#include<vector>
+#include<map>
+#include<string>
+#include<iostream>
+
+#include "math/linear_solver/krylov/generalized_minimal_residual_method.hpp"
+
+/**
+ * \brief Mixed precision iterative refinement.  Solves the linear system A*x = b to the accuracy of
+ *  value_type while the Krylov iterations run with an operator in inner_value_type (usually float).
+ *
+ *  Each outer iteration computes the residual r = b - A*x in value_type, solves A_low*d = r/|r| with
+ *  GMRES in inner_value_type and updates x += |r|*d.  Scaling the residual keeps the inner right hand
+ *  side at unit norm, away from the underflow range of the low precision type.
+ *
+ * \param value_type Precision of the solution and the residual.
+ * \param inner_value_type Precision of the inner Krylov solve.
+ * \param krylov_space_maximum_dimension Maximum dimension of the inner Krylov space.
+ * \param krylov_restarts Maximum number of GMRES restarts per inner solve.
+ **/
+template < typename value_type, typename inner_value_type = float, int krylov_space_maximum_dimension = 50, int krylov_restarts = 10 >
+class IterativeRefinement
+{
+    protected:
+        typedef GeneralizedMinimalResidualMethod<inner_value_type, krylov_space_maximum_dimension> inner_solver_type;
+        typedef std::map<std::string, std::vector<inner_value_type> >                          inner_stats_type;
+
+    private:
+        size_t                          m_system_size;
+        size_t                          m_max_iterations;
+        inner_value_type                m_inner_tolerance;
+        inner_solver_type               m_inner_solver;
+        std::vector<value_type>         m_residual;
+        std::vector<inner_value_type>   m_inner_residual;
+        std::vector<inner_value_type>   m_correction;
+
+    public:
+        IterativeRefinement(size_t system_size) :
+                m_system_size(system_size),
+                m_max_iterations(20),
+                m_inner_tolerance(inner_value_type(1e-4)),
+                m_inner_solver(system_size),
+                m_residual(system_size),
+                m_inner_residual(system_size),
+                m_correction(system_size)
+        {}
+
+        inline size_t system_size() { return m_system_size; }
+        inline void setMaxIterations(size_t iterations) { m_max_iterations = iterations; }
+        inline void setInnerTolerance(inner_value_type tol) { m_inner_tolerance = tol; }
+
+        /**
+         * \brief Refinement loop.
+         *
+         * \param A High precision linear operator, A(x,Ax), evaluated in value_type.
+         * \param A_low Low precision linear operator, A_low(x,Ax), evaluated in inner_value_type.
+         * \param b Right hand side vector of the linear system.
+         * \param x Initial guess and solution vector.
+         * \param tol Relative tolerance for the high precision residual.
+         * \param stats Optional map to collect statistics of the method.  Defaults to 0.
+         * \return 0 if the relative residual is below tol, 1 otherwise.
+         **/
+        template<typename operator_type, typename inner_operator_type>
+        int operator()(operator_type &A, inner_operator_type &A_low, const value_type *b, value_type *x, value_type tol = 1e-12, std::map<std::string, std::vector<value_type> > *stats = 0)
+        {
+            value_type bnorm = norm(b);
+            if(bnorm == value_type(0))
+                bnorm = value_type(1);
+
+            value_type rnorm = residual(A, b, x);
+            size_t itc = 0;
+            size_t inner_its = 0;
+            if(stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *stats;
+                s["refinement_residuals"].push_back(rnorm / bnorm);
+            }
+
+            while(rnorm > tol * bnorm && itc < m_max_iterations)
+            {
+                ++itc;
+                inner_value_type scale = inner_value_type(1) / static_cast<inner_value_type>(rnorm);
+                for(size_t i = 0; i < m_system_size; ++i)
+                {
+                    m_inner_residual[i] = static_cast<inner_value_type>(m_residual[i]) * scale;
+                    m_correction[i] = inner_value_type(0);
+                }
+
+                /// Solve for the correction in low precision
+                inner_stats_type inner_stats;
+                inner_value_type k_err = std::numeric_limits<inner_value_type>::infinity();
+                unsigned int k_it = 0;
+                while(k_err > m_inner_tolerance && k_it++ < krylov_restarts)
+                    k_err = m_inner_solver(A_low, &m_inner_residual[0], &m_correction[0], m_inner_tolerance, &inner_stats);
+                std::vector<inner_value_type> &fn_evals = inner_stats["gmres_fn_eval"];
+                size_t its = 0;
+                for(size_t i = 0; i < fn_evals.size(); ++i)
+                    its += static_cast<size_t>(fn_evals[i]);
+                inner_its += its;
+
+                /// Update the solution in high precision
+                for(size_t i = 0; i < m_system_size; ++i)
+                    x[i] += rnorm * static_cast<value_type>(m_correction[i]);
+
+                rnorm = residual(A, b, x);
+                if(stats)
+                {
+                    std::map<std::string, std::vector<value_type> > &s = *stats;
+                    s["refinement_residuals"].push_back(rnorm / bnorm);
+                    s["refinement_inner_iterations"].push_back(its);
+                }
+            }
+            if(stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *stats;
+                s["refinement_outer_iterations"].push_back(itc);
+                s["refinement_total_inner_iterations"].push_back(inner_its);
+            }
+
+            if(rnorm > tol * bnorm)
+            {
+                std::cout << "Iterative refinement failed to converge to desired accuracy. Relative residual = " << rnorm / bnorm << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
+    private:
+        /**
+         * \brief Computes r = b - A*x in high precision and returns |r|.
+         **/
+        template<typename operator_type>
+        inline value_type residual(operator_type &A, const value_type *b, value_type *x)
+        {
+            A(x, &m_residual[0]);
+            for(size_t i = 0; i < m_system_size; ++i)
+                m_residual[i] = b[i] - m_residual[i];
+            return norm(&m_residual[0]);
+        }
+
+        inline value_type norm(const value_type *x)
+        {
+            value_type s = value_type(0);
+            for(size_t i = 0; i < m_system_size; ++i)
+                s += x[i] * x[i];
+            return std::sqrt(s);
+        }
+};
+
+#endif
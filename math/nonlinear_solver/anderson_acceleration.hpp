@@ -0,0 +1,168 @@
+#ifndef ANDERSON_ACCELERATION_HPP
+#define ANDERSON_ACCELERATION_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<limits>
+#include<vector>
+#include<map>
+#include<string>
+#include<iostream>
+#include<algorithm>
+
+#include "utils/ring_buffer.hpp"
+#include "math/linear_solver/direct/history_least_squares.hpp"
+
+/**
+ * \brief Anderson accelerated fixed point iteration.  It solves F(x) = 0 where F(x) = x - G(x)
+ *  and G is the fixed point map.
+ *
+ *  Each iteration takes one evaluation of F.  The new iterate combines the last window+1 iterates
+ *  with the coefficients that minimize the linearized residual,
+ *
+ *      x_{k+1} = x_k + beta*r_k - (dX + beta*dR)*gamma,  gamma = argmin |r_k - dR*gamma|,
+ *
+ *  where r = -F(x) and dX, dR hold the differences of successive iterates and residuals.  The
+ *  least squares problem is solved with a QR factorization, see HistoryLeastSquares.  Storage is
+ *  O(window*N).
+ *
+ * \param window Number of previous differences kept.
+ **/
+template<typename value_type, int window = 5>
+class AndersonAcceleration
+{
+    private:
+        size_t                          m_system_size;
+        size_t                          m_maxitc;
+        value_type                      m_beta;
+        RingBuffer<value_type>          m_dx;       //< Iterate differences
+        RingBuffer<value_type>          m_dr;       //< Residual differences
+        HistoryLeastSquares<value_type> m_least_squares;
+        std::vector<value_type>         m_r;
+        std::vector<value_type>         m_x_old;
+        std::vector<value_type>         m_r_old;
+
+    public:
+        AndersonAcceleration(size_t system_size) :
+                m_system_size(system_size),
+                m_maxitc(100),
+                m_beta(value_type(1)),
+                m_dx(window, system_size),
+                m_dr(window, system_size),
+                m_least_squares(window, system_size),
+                m_r(system_size),
+                m_x_old(system_size),
+                m_r_old(system_size)
+        {}
+
+        inline size_t system_size() { return m_system_size; }
+        inline void setMaxIterations(size_t iterations) { m_maxitc = iterations; }
+        inline void setMixing(value_type beta) { m_beta = beta; }
+
+        /**
+        * \brief Anderson iterations.  It solves F(x) = 0.
+        *
+        * \param F Non-Linear Function.  This is actually a functor (function object).
+        * \param x Initial guess and result vector.
+        * \param atol Absolute tolerance.
+        * \param rtol Relative tolerance.
+        * \param stats Vector to collect statistics about the method. Defaults to 0.
+        **/
+        template<typename operator_type>
+        int operator()(operator_type &F, value_type *x, value_type atol = 1e-3, value_type rtol = 1e-4, std::map<std::string, std::vector<value_type> > *stats = 0)
+        {
+            size_t N = m_system_size;
+            F(x, &m_r[0]);
+            for(size_t i = 0; i < N; ++i)
+                m_r[i] = -m_r[i];
+            value_type fnrm = norm(&m_r[0]);
+            value_type stop_tol = atol + rtol * fnrm;
+            if(stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *stats;
+                s["anderson_norm"].push_back(fnrm);
+                s["anderson_fn_eval"].push_back(1);
+            }
+
+            size_t itc = 0;
+            m_dx.clear();
+            m_dr.clear();
+            while(fnrm > stop_tol && itc < m_maxitc)
+            {
+                if(itc > 0)
+                {
+                    /// Store the newest differences
+                    value_type *dx = m_dx.push(0), *dr = m_dr.push(0);
+                    for(size_t i = 0; i < N; ++i)
+                    {
+                        dx[i] = x[i] - m_x_old[i];
+                        dr[i] = m_r[i] - m_r_old[i];
+                    }
+                }
+                std::copy(x, x + N, m_x_old.begin());
+                std::copy(m_r.begin(), m_r.end(), m_r_old.begin());
+                ++itc;
+
+                size_t m = m_least_squares.solve(m_dr, &m_r[0], value_type(1e3) * std::numeric_limits<value_type>::epsilon());
+
+                for(size_t i = 0; i < N; ++i)
+                    x[i] += m_beta * m_r[i];
+                for(size_t j = 0; j < m; ++j)
+                {
+                    const value_type *dx = m_dx[m_least_squares.column(j)], *dr = m_dr[m_least_squares.column(j)];
+                    value_type gamma = m_least_squares.coefficient(j);
+                    for(size_t i = 0; i < N; ++i)
+                        x[i] -= gamma * (dx[i] + m_beta * dr[i]);
+                }
+
+                F(x, &m_r[0]);
+                for(size_t i = 0; i < N; ++i)
+                    m_r[i] = -m_r[i];
+                fnrm = norm(&m_r[0]);
+                if(stats)
+                {
+                    std::map<std::string, std::vector<value_type> > &s = *stats;
+                    s["anderson_norm"].push_back(fnrm);
+                    s["anderson_fn_eval"].push_back(s["anderson_fn_eval"].back() + 1);
+                }
+            }
+
+            if(fnrm > stop_tol)
+            {
+                std::cout << "Anderson acceleration failed to converge to desired accuracy. Function Norm = " << fnrm << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+
+    private:
+        inline value_type dot(const value_type *x, const value_type *y)
+        {
+            value_type s = value_type(0);
+            for(size_t i = 0; i < m_system_size; ++i)
+                s += x[i] * y[i];
+            return s;
+        }
+
+        inline value_type norm(const value_type *x)
+        {
+            return std::sqrt(dot(x, x));
+        }
+};
+
+#endif
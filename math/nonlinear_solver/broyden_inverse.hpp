@@ -0,0 +1,90 @@
+#ifndef BROYDEN_INVERSE_HPP
+#define BROYDEN_INVERSE_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<limits>
+#include<vector>
+#include<algorithm>
+
+#include "utils/ring_buffer.hpp"
+#include "math/linear_solver/direct/history_least_squares.hpp"
+
+/**
+ * \brief Limited memory approximation of an inverse Jacobian from the last secant pairs (s_i,y_i),
+ *  y_i ~ J*s_i.  Generalized ("multisecant") Broyden update of the second kind,
+ *
+ *      H = I + (S - Y)*(Y^T*Y)^{-1}*Y^T,
+ *
+ *  which satisfies H*y_i = s_i for every stored pair and acts as the identity on the orthogonal
+ *  complement of the y_i.  The identity is a good initial approximation for implicit time steps
+ *  where the Jacobian is I - dt*J.  The pairs live in RingBuffers, the oldest pair is dropped
+ *  when they are full.  Applying H solves a small least squares problem with a QR factorization
+ *  of Y, see HistoryLeastSquares.
+ *
+ *  Pairs with nearly dependent y are dropped when H is applied, so the approximation stays well
+ *  defined.
+ **/
+template<typename value_type>
+class BroydenInverse
+{
+    private:
+        size_t                          m_system_size;
+        RingBuffer<value_type>          m_s;
+        RingBuffer<value_type>          m_y;
+        HistoryLeastSquares<value_type> m_least_squares;
+
+    public:
+        BroydenInverse(size_t system_size, size_t max_pairs = 10) :
+                m_system_size(system_size),
+                m_s(max_pairs, system_size),
+                m_y(max_pairs, system_size),
+                m_least_squares(max_pairs, system_size)
+        {}
+
+        inline size_t pairs() { return m_y.size(); }
+        inline void reset() { m_s.clear(); m_y.clear(); }
+
+        /**
+         * \brief Store the secant pair (s,y).
+         **/
+        void update(const value_type *s, const value_type *y)
+        {
+            m_s.push(0, s);
+            m_y.push(0, y);
+        }
+
+        /**
+         * \brief Computes Hv = H*v = v + (S - Y)*gamma, gamma = argmin |v - Y*gamma|.
+         **/
+        void apply(const value_type *v, value_type *Hv)
+        {
+            size_t N = m_system_size;
+            size_t m = m_least_squares.solve(m_y, v, std::sqrt(std::numeric_limits<value_type>::epsilon()));
+            std::copy(v, v + N, Hv);
+            for(size_t j = 0; j < m; ++j)
+            {
+                const value_type *s = m_s[m_least_squares.column(j)], *y = m_y[m_least_squares.column(j)];
+                value_type gamma = m_least_squares.coefficient(j);
+                for(size_t i = 0; i < N; ++i)
+                    Hv[i] += gamma * (s[i] - y[i]);
+            }
+        }
+};
+
+#endif
@@ -25,7 +25,9 @@
 
 #include "math/nonlinear_solver/newton_storage.hpp"
 #include "math/nonlinear_solver/newton_base.hpp"
+#include "math/nonlinear_solver/broyden_inverse.hpp"
 #include "math/linear_solver/krylov/generalized_minimal_residual_method.hpp"
+#include "math/linear_solver/preconditioner/identity_preconditioner.hpp"
 
 
 /**
@@ -33,10 +35,16 @@
  * Inexact-Newton-Armijo iteration.
  * Eisenstat-Walker forcing term.
  * Parabolic line search via three point interpolation.
- * Computes Jacobian using finite differences.
+ * Computes Jacobian-vector products using finite differences by default.  Use
+ * dual_directional_derivative as jacobian_type for exact products.
+ *
+ * Optionally (setQuasiNewton) each iteration first tries a quasi-Newton step with a Broyden
+ * approximation of the inverse Jacobian that is kept across calls.  The Newton-Krylov step is
+ * only computed when the quasi-Newton step fails the Armijo test.
  **/
-template< typename value_type,int k_max,int k_restart, typename linear_solver_type = GeneralizedMinimalResidualMethod<value_type,k_max> >
-class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_max,k_restart,linear_solver_type> >
+template< typename value_type,int k_max,int k_restart, typename linear_solver_type = GeneralizedMinimalResidualMethod<value_type,k_max>,
+          template<typename,typename> class jacobian_type = directional_derivative >
+class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_max,k_restart,linear_solver_type,jacobian_type> >
 {
     private:
         size_t m_system_size;
@@ -45,7 +53,12 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
         linear_solver_type m_gmres;
         value_type 			m_gamma;
         value_type 			m_forcing_term;
-        
+        bool                            m_quasi_newton;
+        value_type                      m_quasi_newton_contraction;
+        BroydenInverse<value_type>      m_broyden;
+        std::vector<value_type>         m_x_old;
+        std::vector<value_type>         m_f_old;
+
     public:
 
         InexactNewtonMethod(size_t system_size) :
@@ -54,13 +67,33 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
                 m_storage(system_size),
                 m_gmres(system_size),
                 m_gamma ( value_type ( .9 ) ),
-                m_forcing_term ( value_type ( .9 ) )
+                m_forcing_term ( value_type ( .9 ) ),
+                m_quasi_newton ( false ),
+                m_quasi_newton_contraction ( value_type ( .5 ) ),
+                m_broyden ( system_size )
         {};
 
         inline value_type *dx() { return m_storage.dx(); }
         inline value_type *f() { return m_storage.f(); }
         inline value_type &dx ( size_t i ) { return m_storage.dx ()[i]; }
         inline size_t system_size() { return m_system_size; }
+        inline linear_solver_type &linear_solver() { return m_gmres; }
+
+        /**
+        * \brief Enable or disable the quasi-Newton steps.  Disabled by default.
+        *
+        * \param quasi_newton Try a quasi-Newton step before each Newton-Krylov step.
+        * \param contraction A quasi-Newton step is only tried again if the previous iteration reduced
+        *   the residual norm at least by this factor, otherwise a Newton-Krylov step is taken.
+        **/
+        inline void setQuasiNewton(bool quasi_newton, value_type contraction = .5)
+        {
+            m_quasi_newton = quasi_newton;
+            m_quasi_newton_contraction = contraction;
+            m_x_old.resize(quasi_newton ? m_system_size : 0);
+            m_f_old.resize(quasi_newton ? m_system_size : 0);
+            m_broyden.reset();
+        }
 
         /**
         * \brief Newton iterations routine.  It solves F(x) = 0.
@@ -75,8 +108,26 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
         template< typename operator_type>
         int operator() ( operator_type &F, value_type *x, value_type atol = 1e-3, value_type rtol = 1e-4, std::map<std::string,std::vector<value_type> > *stats = 0 )
         {
-            typedef directional_derivative<operator_type,value_type>   jacobian_operator_type;
-            jacobian_operator_type jacobian ( F,x,f(),m_system_size);
+            IdentityPreconditioner<value_type> M(m_system_size);
+            return operator()(F, M, x, atol, rtol, stats);
+        }
+
+        /**
+        * \brief Preconditioned Newton iterations routine.  It solves F(x) = 0.
+        *
+        * \param F Non-Linear Function.  This is actually a functor (function object).
+        * \param M Right preconditioner for the Jacobian systems, M(r,z) computes z = M^{-1}r.
+        * \param x Initial guess and result vector.
+        * \param atol Absolute tolerance.
+        * \param rtol Relative tolerance.
+        * \param stats Vector to collect statistics about the method. Defaults to 0.
+        *
+        **/
+        template< typename operator_type, typename preconditioner_type>
+        int operator() ( operator_type &F, preconditioner_type &M, value_type *x, value_type atol = 1e-3, value_type rtol = 1e-4, std::map<std::string,std::vector<value_type> > *stats = 0 )
+        {
+            typedef jacobian_type<operator_type,value_type>   jacobian_operator_type;
+            jacobian_operator_type jacobian ( F,x,f(),m_system_size,m_storage.workspace ( jacobian_operator_type::workspace_size ( m_system_size ) ) );
             /// Evaluate F at initial iterate and compute the stop tolerance
 
             F ( x,f() );
@@ -107,11 +158,31 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
                 itc++;                                                          // Newton iteration counter
                 value_type rat = fnrm / fnrmo;                                  // Compute ratio of succesive residual norms and iteration counter
                 fnrmo = fnrm;                                                   // Store old function norm
+                bool quasi_step = m_quasi_newton && ( itc == 1 || rat <= m_quasi_newton_contraction );
+                if ( m_quasi_newton )
+                {
+                    std::copy ( x, x + m_system_size, m_x_old.begin() );
+                    std::copy ( f(), f() + m_system_size, m_f_old.begin() );
+                }
+                if ( quasi_step )
+                {
+                    if ( quasi_newton_step ( F, x, fnrm, stats ) )
+                    {
+                        fnrm = this->norm ( f(), m_system_size );
+                        if(stats)
+                        {
+                            std::map<std::string,std::vector<value_type> > &s = *stats;
+                            s["newton_norm"].push_back(fnrm);
+                            s["newton_fn_eval"].push_back(s["newton_fn_eval"].back() + (itc == 1 ? 2 : 1));
+                        }
+                        continue;
+                    }
+                }
                 std::fill ( dx(),dx() +m_system_size,value_type ( 0 ) );        // Set initial Krylov iterate to zero
                 value_type k_err = std::numeric_limits<value_type>::infinity(); // Define initial error to infinity                
                 unsigned int k_it = 0;
                 while ( k_err > gmres_tol*fnrm && k_it++ < k_restart && fnrm != 0 ) // Solve for descend direction using GMRES
-                    k_err = m_gmres ( jacobian, f(), dx(), gmres_tol, stats );
+                    k_err = m_gmres ( jacobian, M, f(), dx(), gmres_tol, stats );
 
                 std::transform(x, x + m_system_size,dx(),x,std::minus<value_type>()); // Update x: x = x + -dx.  dx = steppest descent direction
                                 
@@ -143,6 +214,8 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
                 fnrmo = fnrm;
                 fnrm = fnorm[1];
                 rat = fnrm / fnrmo;
+                if ( m_quasi_newton )
+                    secant_update ( x );
                 if(stats)
                 {
                     std::map<std::string,std::vector<value_type> > &s = *stats;
@@ -159,16 +232,17 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
                             + s[fn_eval_gmres_key].back() // Function evaluations from GMRES
                             + s[armijo_it_key].back() + 1; // Function evaluations from the armijo iterations
                     if(itc == 1) total_fn_evals++;
+                    if(quasi_step) total_fn_evals++; // Rejected quasi-Newton step
                     s[fn_eval_newton_key].push_back(total_fn_evals);
                 }
                 /// Adjust eta as per Eisenstat-Walker.
                 if ( m_forcing_term > 0 )
                 {
-                    value_type etaold = m_forcing_term;
+                    value_type etaold = gmres_tol;
                     value_type etanew = m_gamma * rat * rat;
                     if ( m_gamma*etaold*etaold > .1 )
                         etanew = std::max ( etanew, m_gamma * etaold * etaold );
-                    gmres_tol = std::max ( std::min ( etanew, etaold ), value_type ( 0.5 ) * stop_tol / fnrm );
+                    gmres_tol = std::max ( std::min ( etanew, m_forcing_term ), value_type ( 0.5 ) * stop_tol / fnrm );
                 }
             }
             
@@ -180,10 +254,51 @@ class InexactNewtonMethod: public NewtonBase<InexactNewtonMethod<value_type,k_ma
             return 0;
         }
 
+    private:
+        /**
+        * \brief Tries the step x = x - H*F(x).  On failure of the Armijo test x and F(x) are restored.
+        *
+        * \return true if the step was accepted.
+        **/
+        template< typename operator_type>
+        bool quasi_newton_step ( operator_type &F, value_type *x, value_type fnrm, std::map<std::string,std::vector<value_type> > *stats )
+        {
+            m_broyden.apply ( f(), dx() );
+            std::transform ( x, x + m_system_size, dx(), x, std::minus<value_type>() );
+            F ( x, f() );
+            bool accepted = this->armijo_condition ( this->norm ( f(), m_system_size ), fnrm, value_type ( 1 ) );
+            if ( accepted )
+                secant_update ( x );
+            else
+            {
+                std::copy ( m_x_old.begin(), m_x_old.end(), x );
+                std::copy ( m_f_old.begin(), m_f_old.end(), f() );
+            }
+            if(stats)
+            {
+                std::map<std::string,std::vector<value_type> > &s = *stats;
+                s[accepted ? "quasi_newton_steps" : "quasi_newton_fallbacks"].push_back(1);
+            }
+            return accepted;
+        }
+
+        /**
+        * \brief Broyden update with the last step, s = x - x_old and y = F(x) - F(x_old).
+        **/
+        inline void secant_update ( const value_type *x )
+        {
+            for ( size_t i = 0; i < m_system_size; ++i )
+            {
+                m_x_old[i] = x[i] - m_x_old[i];
+                m_f_old[i] = f()[i] - m_f_old[i];
+            }
+            m_broyden.update ( &m_x_old[0], &m_f_old[0] );
+        }
+
 };
 
-template<typename _value_type,int _k_max, int _k_restart, typename _krylov_method_type>
-struct newton_traits<InexactNewtonMethod<_value_type,_k_max,_k_restart,_krylov_method_type> >
+template<typename _value_type,int _k_max, int _k_restart, typename _krylov_method_type, template<typename,typename> class _jacobian_type>
+struct newton_traits<InexactNewtonMethod<_value_type,_k_max,_k_restart,_krylov_method_type,_jacobian_type> >
 {
     typedef _value_type value_type;
     enum
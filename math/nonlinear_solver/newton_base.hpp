@@ -19,6 +19,7 @@
 ****************************************************************************/
 #include<iterator>
 #include<cassert>
+#include<vector>
 
 template<typename T>
 class newton_traits;
@@ -49,12 +50,24 @@ class NewtonBase
             return *static_cast<Derived*> ( this );
         }
 
+        /**
+         * \brief Sufficient decrease test of the line search, |F(x + lambda*d)| < (1 - alpha*lambda)*|F(x)|.
+         *
+         * \param fnorm_new Value of |F(x + lambda*d)|
+         * \param fnorm_old Value of |F(x)|
+         * \param lambda Steplength
+         **/
+        inline bool armijo_condition ( value_type fnorm_new, value_type fnorm_old, value_type lambda )
+        {
+            return fnorm_new < ( value_type ( 1 ) - m_alpha * lambda ) * fnorm_old;
+        }
+
         template< typename operator_type, typename vector_type>
         inline bool armijo ( operator_type &F, value_type *x, value_type lambda[3], value_type fnorm[2], value_type fnorm_sqr[3], std::map<std::string,vector_type> *stats = 0 )
         {
             size_t system_size = derived().system_size();
             unsigned int iarm = 0; // Armijo iteration counter
-            while ( fnorm[1] >= ( value_type ( 1 ) - m_alpha * lambda[0] ) *fnorm[0] )
+            while ( !armijo_condition ( fnorm[1], fnorm[0], lambda[0] ) )
             {
                 /// Apply three point parabolic model
                 if ( iarm == 0 )
@@ -135,7 +148,7 @@ class NewtonBase
             value_type s = value_type ( 0 );
             for ( size_t i = 0; i < system_size; ++i )
                 s += x[i] * y[i];
-            assert(!isnan(s));
+            assert(!std::isnan(s));
             return s;
         }
         inline value_type norm ( const value_type *x, size_t system_size )
@@ -156,6 +169,8 @@ class NewtonBase
  * \param f0 F(x)
  * \param z Resultant derivative.
  * \param eps Difference increment. Defaults to value_type(1e-7).
+ * \param workspace Scratch space of workspace_size(system_size) entries, e.g. from
+ *   newton_storage.  If 0 it is allocated here.
  *
  **/
 template<typename operator_type, typename value_type>
@@ -166,8 +181,13 @@ struct directional_derivative
     const value_type *m_x;
     const value_type *m_f0;
     size_t m_system_size;
+    value_type *m_workspace;
+    std::vector<value_type> m_own_workspace;
+
+    directional_derivative ( operator_type &F, const value_type *x, const value_type *f0, size_t system_size, value_type *workspace = 0 ) :
+        m_F ( F ), m_x ( x ), m_f0 ( f0 ), m_system_size ( system_size ), m_workspace ( workspace ), m_own_workspace ( workspace ? 0 : workspace_size ( system_size ) ) {}
 
-    directional_derivative ( operator_type &F, const value_type *x, const value_type *f0, size_t system_size ) : m_F ( F ), m_x ( x ), m_f0 ( f0 ), m_system_size ( system_size ) {}
+    static inline size_t workspace_size ( size_t system_size ) { return 2 * system_size; }
 
     inline void operator() ( const value_type *w, value_type *DF, value_type eps = value_type ( 1e-9 ) )
     {
@@ -187,11 +207,12 @@ struct directional_derivative
         /// Scale the difference increment
         eps /= wnorm;
 
-        std::vector<value_type> f1(m_system_size);
-        std::vector<value_type> x1(m_system_size);
+        value_type *x1 = m_workspace ? m_workspace : &m_own_workspace[0];
+        value_type *f1 = x1 + m_system_size;
         for ( size_t i = 0; i < m_system_size; ++i )
             x1[i] = m_x[i] + eps * w[i];
-        m_F ( &x1[0], &f1[0] );
+        std::fill ( f1, f1 + m_system_size, value_type ( 0 ) );
+        m_F ( x1, f1 );
         value_type h = value_type ( 1 ) / eps;
         for ( size_t i = 0; i < m_system_size; ++i )
             DF[i] = ( f1[i] - m_f0[i] ) * h;
@@ -25,6 +25,8 @@ struct newton_arrays
 {
     T *dx;
     T *f;
+    T *workspace;
+    size_t workspace_size;
 };
 
 /** \internal
@@ -47,6 +49,8 @@ class newton_storage
         {
             m_data.dx = new T[size];
             m_data.f = new T[size];
+            m_data.workspace = 0;
+            m_data.workspace_size = 0;
             clear(size);
         }
         void clear(size_t size)
@@ -58,12 +62,28 @@ class newton_storage
         {
             delete [] m_data.dx;
             delete [] m_data.f;
+            delete [] m_data.workspace;
         }
         inline void swap ( newton_storage& other ) { std::swap ( m_data,other.m_data ); }
 
         inline T *dx() { return m_data.dx; }
         inline T &dx(size_t i) { return * ( m_data.dx+i); }
         inline T *f ( ) { return m_data.f; }
+
+        /**
+         * \brief Scratch space of the Jacobian operator, kept between solves.  It is only
+         *  reallocated when a larger one is requested.
+         **/
+        inline T *workspace ( size_t size )
+        {
+            if ( m_data.workspace_size < size )
+            {
+                delete [] m_data.workspace;
+                m_data.workspace = new T[size];
+                m_data.workspace_size = size;
+            }
+            return m_data.workspace;
+        }
 };
 
 
@@ -0,0 +1,274 @@
+#ifndef ADDITIVE_RUNGE_KUTTA_HPP
+#define ADDITIVE_RUNGE_KUTTA_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/euler/backward_euler.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+
+/**
+ * \brief Butcher tableaux of the additive Runge-Kutta methods.
+ *
+ *  The explicit and the implicit (ESDIRK, first stage explicit) tableaux share the nodes c and the
+ *  weights b.  The matrices are stages x stages, row major, and bhat are the weights of the
+ *  embedded method of order embedded_order.
+ **/
+
+/**
+ * \brief ARK3(2)4L[2]SA of Kennedy and Carpenter, third order, 3 implicit stages.
+ **/
+struct ARK324L2SA
+{
+    enum { stages = 4, order = 3, embedded_order = 2 };
+
+    static const double *explicit_matrix()
+    {
+        static const double A[] =
+        {
+            0, 0, 0, 0,
+            1767732205903. / 2027836641118., 0, 0, 0,
+            5535828885825. / 10492691773637., 788022342437. / 10882634858940., 0, 0,
+            6485989280629. / 16251701735622., -4246266847089. / 9704473918619., 10755448449292. / 10357097424841., 0
+        };
+        return A;
+    }
+
+    static const double *implicit_matrix()
+    {
+        static const double g = 1767732205903. / 4055673282236.;
+        static const double A[] =
+        {
+            0, 0, 0, 0,
+            g, g, 0, 0,
+            2746238789719. / 10658868560708., -640167445237. / 6845629431997., g, 0,
+            1471266399579. / 7840856788654., -4482444167858. / 7529755066697., 11266239266428. / 11593286722821., g
+        };
+        return A;
+    }
+
+    static const double *weights()
+    {
+        return implicit_matrix() + 3 * stages;
+    }
+
+    static const double *embedded_weights()
+    {
+        static const double b[] =
+        {
+            2756255671327. / 12835298489170., -10771552573575. / 22201958757719., 9247589265047. / 10645013368117., 2193209047091. / 5459859503100.
+        };
+        return b;
+    }
+
+    static const double *nodes()
+    {
+        static const double c[] = {0, 1767732205903. / 2027836641118., 3. / 5., 1};
+        return c;
+    }
+};
+
+/**
+ * \brief ARK4(3)6L[2]SA of Kennedy and Carpenter, fourth order, 5 implicit stages.
+ **/
+struct ARK436L2SA
+{
+    enum { stages = 6, order = 4, embedded_order = 3 };
+
+    static const double *explicit_matrix()
+    {
+        static const double A[] =
+        {
+            0, 0, 0, 0, 0, 0,
+            1. / 2., 0, 0, 0, 0, 0,
+            13861. / 62500., 6889. / 62500., 0, 0, 0, 0,
+            -116923316275. / 2393684061468., -2731218467317. / 15368042101831., 9408046702089. / 11113171139209., 0, 0, 0,
+            -451086348788. / 2902428689909., -2682348792572. / 7519795681897., 12662868775082. / 11960479115383., 3355817975965. / 11060851509271., 0, 0,
+            647845179188. / 3216320057751., 73281519250. / 8382639484533., 552539513391. / 3454668386233., 3354512671639. / 8306763924573., 4040. / 17871., 0
+        };
+        return A;
+    }
+
+    static const double *implicit_matrix()
+    {
+        static const double A[] =
+        {
+            0, 0, 0, 0, 0, 0,
+            1. / 4., 1. / 4., 0, 0, 0, 0,
+            8611. / 62500., -1743. / 31250., 1. / 4., 0, 0, 0,
+            5012029. / 34652500., -654441. / 2922500., 174375. / 388108., 1. / 4., 0, 0,
+            15267082809. / 155376265600., -71443401. / 120774400., 730878875. / 902184768., 2285395. / 8070912., 1. / 4., 0,
+            82889. / 524892., 0, 15625. / 83664., 69875. / 102672., -2260. / 8211., 1. / 4.
+        };
+        return A;
+    }
+
+    static const double *weights()
+    {
+        return implicit_matrix() + 5 * stages;
+    }
+
+    static const double *embedded_weights()
+    {
+        static const double b[] =
+        {
+            4586570599. / 29645900160., 0, 178811875. / 945068544., 814220225. / 1159782912., -3700637. / 11593932., 61727. / 225920.
+        };
+        return b;
+    }
+
+    static const double *nodes()
+    {
+        static const double c[] = {0, 1. / 2., 83. / 250., 31. / 50., 17. / 20., 1};
+        return c;
+    }
+};
+
+/**
+ * \brief Additive (IMEX) Runge-Kutta method with the same interface as SemiImplicitSDC.
+ *
+ *  F.Explicit is integrated with the explicit tableau and F.Implicit with the ESDIRK one, the stages
+ *
+ *      X_i - Dt*a_ii*Fi(X_i) = x + Dt*sum_{j<i} (ae_ij*Fe_j + ai_ij*Fi_j)
+ *
+ *  are solved with BackwardEuler.  A step costs stages-1 implicit solves and stages explicit
+ *  evaluations, the right hand sides at the end of the step are those of the next first stage.
+ *  For moderate accuracy this is cheaper than SDC with few nodes and corrections.
+ *
+ *  previous_sweep() returns the embedded solution so the step can be controlled as the SDC ones,
+ *  see Surface::run().
+ *
+ * \param tableau_type ARK324L2SA or ARK436L2SA.
+ **/
+template<typename value_type, typename tableau_type = ARK324L2SA>
+class AdditiveRungeKutta
+{
+    protected:
+        typedef BackwardEuler<value_type> backward_euler_type;
+        enum
+        {
+            stages = tableau_type::stages
+        };
+
+    protected:
+        size_t                  m_ode_size;
+        backward_euler_type     m_backward_euler;
+        std::vector<value_type> m_Fi[stages];
+        std::vector<value_type> m_Fe[stages];
+        std::vector<value_type> m_stage;
+        std::vector<value_type> m_rhs;
+        std::vector<value_type> m_embedded;
+        value_type              m_ae[stages * stages];
+        value_type              m_ai[stages * stages];
+        value_type              m_b[stages];
+        value_type              m_bhat[stages];
+        value_type              m_c[stages];
+        bool                    m_initialized;
+
+    public:
+        AdditiveRungeKutta(size_t ode_size) : m_ode_size(ode_size), m_backward_euler(ode_size), m_stage(ode_size), m_rhs(ode_size), m_embedded(ode_size), m_initialized(false)
+        {
+            for(int i = 0; i < stages; ++i)
+            {
+                m_Fi[i].resize(ode_size);
+                m_Fe[i].resize(ode_size);
+                m_b[i] = tableau_type::weights()[i];
+                m_bhat[i] = tableau_type::embedded_weights()[i];
+                m_c[i] = tableau_type::nodes()[i];
+            }
+            for(int i = 0; i < stages * stages; ++i)
+            {
+                m_ae[i] = tableau_type::explicit_matrix()[i];
+                m_ai[i] = tableau_type::implicit_matrix()[i];
+            }
+        }
+
+        inline size_t ode_size()                        { return m_ode_size; }
+        inline backward_euler_type &implicit_solver()   { return m_backward_euler; }
+
+        /**
+         * \brief Embedded solution of the last step.
+         **/
+        inline const value_type *previous_sweep()       { return &m_embedded[0]; }
+
+        /**
+         * \brief Order of the error estimate given by previous_sweep().
+         **/
+        inline int estimate_order() const               { return tableau_type::embedded_order; }
+
+        /**
+         * \brief See SemiImplicitSDC::reset().
+         **/
+        inline void reset() { m_initialized = false; }
+
+        /**
+         * \brief There are no sweeps to diverge, these let Surface::run() use ARK as the SDC methods.
+         **/
+        inline void setThrowOnDivergence(bool) {}
+        inline bool diverged() const { return false; }
+
+        template<typename function_type>
+        void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type Dt)
+        {
+            if(!m_initialized)
+            {
+                F.Implicit(t, x, &m_Fi[0][0]);
+                F.Explicit(t, x, &m_Fe[0][0]);
+                m_initialized = true;
+            }
+
+            implicit_function<function_type> G(F);
+            value_type *rhs = &m_rhs[0], *X = &m_stage[0];
+            for(int i = 1; i < stages; ++i)
+            {
+                std::copy(x, x + m_ode_size, rhs);
+                for(int j = 0; j < i; ++j)
+                {
+                    value_type ae = Dt * m_ae[i * stages + j], ai = Dt * m_ai[i * stages + j];
+                    const value_type *fe = &m_Fe[j][0], *fi = &m_Fi[j][0];
+                    for(size_t k = 0; k < m_ode_size; ++k)
+                        rhs[k] += ae * fe[k] + ai * fi[k];
+                }
+                value_type time = t + m_c[i] * Dt;
+                std::copy(rhs, rhs + m_ode_size, X);
+                m_backward_euler(G, time, X, rhs, &m_Fi[i][0], Dt * m_ai[i * stages + i]);
+                F.Explicit(time, X, &m_Fe[i][0]);
+            }
+
+            value_type *y = &m_embedded[0];
+            std::copy(x, x + m_ode_size, y);
+            for(int j = 0; j < stages; ++j)
+            {
+                value_type b = Dt * m_b[j], bhat = Dt * m_bhat[j];
+                const value_type *fe = &m_Fe[j][0], *fi = &m_Fi[j][0];
+                for(size_t k = 0; k < m_ode_size; ++k)
+                {
+                    value_type f = fe[k] + fi[k];
+                    x[k] += b * f;
+                    y[k] += bhat * f;
+                }
+            }
+
+            F.Implicit(t + Dt, x, &m_Fi[0][0]);
+            F.Explicit(t + Dt, x, &m_Fe[0][0]);
+            std::transform(m_Fe[0].begin(), m_Fe[0].end(), m_Fi[0].begin(), v, std::plus<value_type>());
+        }
+};
+
+#endif
@@ -17,9 +17,12 @@
 ** You should have received a copy of the GNU General Public License
 ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****************************************************************************/
+#include<cmath>
+#include<limits>
 
 #include "math/ode_solver/euler/forward_euler.hpp"
 #include "math/nonlinear_solver/inexact_newton.hpp"
+#include "math/ode_solver/euler/extrapolation_predictor.hpp"
 
 template<typename value_type, typename function_type>
 struct BackwardEulerFunction
@@ -32,10 +35,15 @@ struct BackwardEulerFunction
 
     BackwardEulerFunction(function_type &_F, value_type *_rhs, value_type _t, value_type _dt, size_t _ode_size ) : F(_F), rhs(_rhs), t(_t), dt(_dt), ode_size(_ode_size) {}
 
-    inline void operator()(value_type *x, value_type *Fx)
+    /**
+     * \brief Evaluates x - rhs - dt*F(t,x).  Templated on the scalar type so it can be
+     *  differentiated with Dual numbers, F must then accept T as well.
+     **/
+    template<typename T>
+    inline void operator()(T *x, T *Fx)
     {
-        std::fill(Fx, Fx + ode_size, 0.0);
-        F(t, x, Fx);
+        std::fill(Fx, Fx + ode_size, T(0));
+        F(T(t), x, Fx);
         size_t i;
 #pragma omp parallel for private(i)
         for (i = 0; i < ode_size; ++i)
@@ -46,11 +54,59 @@ struct BackwardEulerFunction
     }
 };
 
-template < typename value_type, int gmres_iterations = 1000, int gmres_restarts = 100 >
+/**
+ * \brief Linearization of x - rhs - dt*F(t,x) about a frozen state x0, w -> w - dt*J(x0)*w.
+ *  J(x0)*w is approximated by a finite difference of F, f0 = F(t0,x0) is given.
+ **/
+template<typename value_type, typename function_type>
+struct LinearizedBackwardEulerOperator
+{
+    function_type &F;
+    value_type t0;
+    const value_type *x0;
+    const value_type *f0;
+    value_type *x1;
+    value_type *f1;
+    value_type dt;
+    size_t ode_size;
+
+    LinearizedBackwardEulerOperator(function_type &_F, value_type _t0, const value_type *_x0, const value_type *_f0, value_type *_x1, value_type *_f1, value_type _dt, size_t _ode_size)
+            : F(_F), t0(_t0), x0(_x0), f0(_f0), x1(_x1), f1(_f1), dt(_dt), ode_size(_ode_size) {}
+
+    inline void operator()(const value_type *w, value_type *Aw)
+    {
+        value_type wnorm = 0, xw = 0;
+        for(size_t i = 0; i < ode_size; ++i)
+        {
+            wnorm += w[i] * w[i];
+            xw += x0[i] * w[i];
+        }
+        wnorm = std::sqrt(wnorm);
+        if(wnorm == 0)
+        {
+            std::fill(Aw, Aw + ode_size, value_type(0));
+            return;
+        }
+        /// Same difference increment as directional_derivative
+        xw /= wnorm;
+        value_type eps = value_type(1e-9) * std::max(std::fabs(xw), value_type(1)) * (xw < 0 ? value_type(-1) : value_type(1)) / wnorm;
+        for(size_t i = 0; i < ode_size; ++i)
+            x1[i] = x0[i] + eps * w[i];
+        std::fill(f1, f1 + ode_size, value_type(0));
+        F(t0, x1, f1);
+        value_type h = dt / eps;
+        for(size_t i = 0; i < ode_size; ++i)
+            Aw[i] = w[i] - h * (f1[i] - f0[i]);
+    }
+};
+
+template < typename value_type, int gmres_iterations = 1000, int gmres_restarts = 100,
+           template<typename,typename> class jacobian_type = directional_derivative >
 class BackwardEuler
 {
     protected:
-        typedef InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts> newton_solver_type;
+        typedef GeneralizedMinimalResidualMethod<value_type, gmres_iterations>                                          linear_solver_type;
+        typedef InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts, linear_solver_type, jacobian_type>    newton_solver_type;
         typedef ForwardEuler                            forward_euler_solver_type;
 
     protected:
@@ -61,23 +117,93 @@ class BackwardEuler
         value_type m_t;
         value_type m_dt;
         size_t ode_size;
+        value_type m_atol;
+        value_type m_rtol;
+        int m_extrapolation_order;
+        ExtrapolationPredictor<value_type> m_extrapolation;
+        std::vector<value_type> m_xold;
+        bool m_linearly_implicit;
+        bool m_linearized;
+        value_type m_linear_tolerance;
+        value_type m_t0;
+        std::vector<value_type> m_linearization[4];    //< Frozen state, F at it and finite difference scratch
 
     public:
-        BackwardEuler(size_t _ode_size) : forward_euler(_ode_size), newton_solver(_ode_size), ode_size(_ode_size)  {}
+        BackwardEuler(size_t _ode_size) : forward_euler(_ode_size), newton_solver(_ode_size), ode_size(_ode_size), m_atol(1e-15), m_rtol(1e-15), m_extrapolation_order(0), m_extrapolation(_ode_size), m_xold(_ode_size), m_linearly_implicit(false), m_linearized(false), m_linear_tolerance(1e-10), m_t0(0)  {}
+
+        inline newton_solver_type &newton() { return newton_solver; }
+
+        /**
+         * \brief Set the tolerances of the Newton solves.  A warm start only saves iterations
+         *  when the absolute tolerance dominates.
+         **/
+        inline void setTolerances(value_type atol, value_type rtol) { m_atol = atol; m_rtol = rtol; }
+
+        /**
+         * \brief Warm start the Newton solves by extrapolating the solutions of the previous
+         *  steps (or SDC nodes) to the new time level.  Disabled by default.
+         *
+         * \param order Degree of the extrapolation polynomial, 0 disables it.
+         **/
+        inline void setExtrapolation(int order)
+        {
+            m_extrapolation_order = order;
+            m_extrapolation = ExtrapolationPredictor<value_type>(ode_size, order > 0 ? order : 0);
+        }
         
+        /**
+         * \brief Replace the Newton iterations by a single linear solve with the Jacobian frozen by
+         *  linearize(), a W-method step.  There is no Newton loop and no line search, each Krylov
+         *  iteration costs one evaluation of F.  Until linearize() is called the Newton iterations
+         *  are used.
+         *
+         * \param tol Relative tolerance of the linear solve.
+         **/
+        inline void setLinearlyImplicit(bool linear, value_type tol = 1e-10)
+        {
+            m_linearly_implicit = linear;
+            m_linearized = false;
+            m_linear_tolerance = tol;
+            for(int i = 0; i < 4; ++i)
+                m_linearization[i].resize(linear ? ode_size : 0);
+        }
+        inline bool linearlyImplicit() const { return m_linearly_implicit; }
+
+        /**
+         * \brief Freeze the Jacobian of F at (t,x), it costs one evaluation of F.  Right hand sides
+         *  recovered from a linearly implicit solve are not F(t,x) exactly, so F is evaluated here.
+         **/
+        template<typename function_type>
+        inline void linearize(function_type &F, value_type t, const value_type *x)
+        {
+            if(!m_linearly_implicit)
+                return;
+            m_t0 = t;
+            std::copy(x, x + ode_size, m_linearization[0].begin());
+            std::fill(m_linearization[1].begin(), m_linearization[1].end(), value_type(0));
+            F(t, &m_linearization[0][0], &m_linearization[1][0]);
+            m_linearized = true;
+        }
+
         template<typename function_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
         {
-            std::vector<value_type> xold(ode_size);
-            std::copy(x,x+ode_size,xold.begin());
-            operator()(F,t,x,&xold[0],v,dt);
+            std::copy(x,x+ode_size,m_xold.begin());
+            operator()(F,t,x,&m_xold[0],v,dt);
         }
 
         template<typename function_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *xold, value_type *v, value_type dt)
         {
             BackwardEulerFunction<value_type, function_type> G(F, xold, t, dt, ode_size);
-            newton_solver(G, x, 1e-15, 1e-15);
+            if(m_extrapolation_order > 0)
+                m_extrapolation.predict(t, x);
+            if(m_linearly_implicit && m_linearized)
+                linear_solve(F, G, x, dt);
+            else
+                newton_solver(G, x, m_atol, m_rtol);
+            if(m_extrapolation_order > 0)
+                m_extrapolation.record(t, x);
             value_type inv_dt = 1.0 / dt;
             size_t i;
 #pragma omp parallel for private(i)
@@ -85,6 +211,30 @@ class BackwardEuler
                 v[i] = inv_dt * (x[i] - xold[i]);
         }
 
+    private:
+        /**
+         * \brief One step x -= (I - dt*J)^{-1} G(x) from the initial guess x, J frozen.  The Newton
+         *  solver's storage and Krylov solver are reused.
+         **/
+        template<typename function_type, typename operator_type>
+        void linear_solve(function_type &F, operator_type &G, value_type *x, value_type dt)
+        {
+            typedef std::map<std::string, std::vector<value_type> > stats_type;
+            value_type *r = newton_solver.f(), *dx = newton_solver.dx();
+            LinearizedBackwardEulerOperator<value_type, function_type> A(F, m_t0, &m_linearization[0][0], &m_linearization[1][0],
+                                                                           &m_linearization[2][0], &m_linearization[3][0], dt, ode_size);
+            G(x, r);
+            value_type rnorm = 0;
+            for(size_t i = 0; i < ode_size; ++i)
+                rnorm += r[i] * r[i];
+            rnorm = std::sqrt(rnorm);
+            std::fill(dx, dx + ode_size, value_type(0));
+            value_type error = std::numeric_limits<value_type>::infinity();
+            for(int k = 0; k < gmres_restarts && rnorm > 0 && error > m_linear_tolerance * rnorm; ++k)
+                error = newton_solver.linear_solver()(A, r, dx, m_linear_tolerance, (stats_type*)0);
+            std::transform(x, x + ode_size, dx, x, std::minus<value_type>());
+        }
+
 };
 
 #endif
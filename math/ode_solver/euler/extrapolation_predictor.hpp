@@ -0,0 +1,83 @@
+#ifndef EXTRAPOLATION_PREDICTOR_HPP
+#define EXTRAPOLATION_PREDICTOR_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include "utils/ring_buffer.hpp"
+
+/**
+ * \brief Initial guess for implicit solves by polynomial extrapolation of the last order+1
+ *  solutions in time.
+ *
+ *  Solutions are recorded with their time level.  Recording a time that is not newer than the
+ *  history (e.g. a new SDC sweep going back over its nodes) first drops the entries at or after
+ *  that time, so the history always holds the latest values of an increasing time sequence.
+ *  A prediction is only made for times newer than the whole history.
+ **/
+template<typename value_type>
+class ExtrapolationPredictor
+{
+    private:
+        int                     m_order;
+        RingBuffer<value_type>  m_history;
+
+    public:
+        ExtrapolationPredictor(size_t size, int order = 2) : m_order(order), m_history(order + 1, size) {}
+
+        inline int order() { return m_order; }
+        inline void clear() { m_history.clear(); }
+
+        /**
+         * \brief Extrapolates the history to time t.
+         *
+         * \param t Time level of the prediction.
+         * \param x Predicted solution.  Unchanged if there is no prediction.
+         * \return true if x was predicted.
+         **/
+        bool predict(value_type t, value_type *x)
+        {
+            size_t n = m_history.size();
+            if(n < 2 || t <= m_history.key(0))
+                return false;
+            size_t size = m_history.vector_size();
+            std::fill(x, x + size, value_type(0));
+            for(size_t j = 0; j < n; ++j)
+            {
+                /// Lagrange basis polynomial of node j evaluated at t
+                value_type w = 1;
+                for(size_t m = 0; m < n; ++m)
+                    if(m != j)
+                        w *= (t - m_history.key(m)) / (m_history.key(j) - m_history.key(m));
+                const value_type *xj = m_history[j];
+                for(size_t i = 0; i < size; ++i)
+                    x[i] += w * xj[i];
+            }
+            return true;
+        }
+
+        /**
+         * \brief Records the solution x at time t.
+         **/
+        void record(value_type t, const value_type *x)
+        {
+            while(!m_history.empty() && m_history.key(0) >= t)
+                m_history.pop();
+            m_history.push(t, x);
+        }
+};
+
+#endif
@@ -24,6 +24,11 @@ class ForwardEuler
     size_t ode_size;
     public:
         ForwardEuler(size_t _ode_size) : ode_size(_ode_size) {}
+
+        /**
+         * \brief Nothing to reset, ForwardEuler keeps no state between steps.
+         **/
+        inline void reset() {}
         
         template<typename function_type, typename value_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *xold, value_type *v, value_type dt)
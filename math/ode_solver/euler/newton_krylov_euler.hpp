@@ -20,12 +20,17 @@
 
 #include "math/ode_solver/euler/backward_euler.hpp"
 #include "math/nonlinear_solver/inexact_newton.hpp"
+#include "math/nonlinear_solver/anderson_acceleration.hpp"
 
-template <typename value_type, typename ode_rhs_type, int gmres_iterations = 100, int gmres_restarts = 10>
+/**
+ * \brief Solves for the fixed point of the backward Euler map.  The nonlinear solver is chosen at
+ *  compile time, e.g. InexactNewtonMethod or AndersonAcceleration.
+ **/
+template <typename value_type, typename ode_rhs_type, int gmres_iterations = 100, int gmres_restarts = 10,
+          typename nonlinear_solver_type = InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts> >
 class NewtonKrylovEuler
 {
     protected:
-        typedef InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts> newton_solver_type;
         class nonlinear_operator
         {
             protected:
@@ -64,15 +69,15 @@ class NewtonKrylovEuler
 
     public:
         nonlinear_operator m_F;
-        newton_solver_type m_newton_solver;
+        nonlinear_solver_type m_nonlinear_solver;
 
     public:
-        NewtonKrylovEuler(ode_rhs_type &F) : m_F(F), m_newton_solver(F.ode_size()) {}
+        NewtonKrylovEuler(ode_rhs_type &F) : m_F(F), m_nonlinear_solver(F.ode_size()) {}
 
         inline void operator()(value_type t, value_type *x, value_type *v, value_type dt)
         {
             m_F.init(t, dt, v);
-            m_newton_solver(m_F, x, 1e-12, 1e-6);
+            m_nonlinear_solver(m_F, x, 1e-12, 1e-6);
         }
 
 };
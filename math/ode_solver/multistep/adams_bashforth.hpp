@@ -0,0 +1,160 @@
+#ifndef ADAMS_BASHFORTH_HPP
+#define ADAMS_BASHFORTH_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+#include "utils/ring_buffer.hpp"
+
+/**
+ * \brief Variable step Adams-Bashforth method of order 1 to 4.
+ *
+ *  The velocities of the last order steps are kept in a RingBuffer keyed by their step sizes.  A step
+ *  integrates the polynomial through them,
+ *
+ *      x_{n+1} = x_n + sum_j w_j v_{n-j},    w_j = int_{t_n}^{t_n+dt} l_j(s) ds,
+ *
+ *  l_j being the Lagrange basis of the past times, so the step size can change freely.  Every step
+ *  needs one new velocity only, the cost of forward Euler.
+ *
+ *  operator()(x,v,dt) is the ForwardEuler one used by ParticleMarkers, v being the velocity at x.
+ *  Until the buffer is full it uses the orders 1, 2, ..., which limits the global error to second
+ *  order unless the first steps are shorter.  operator()(F,t,x,v,dt) takes v = F(t,x) on entry,
+ *  starts with classical Runge-Kutta steps and returns F at the new x in v, so it keeps the full order.
+ *
+ * \param order Order of the method, 1 to 4.
+ **/
+template<typename value_type, int order = 4>
+class AdamsBashforth
+{
+    private:
+        size_t                  m_ode_size;
+        RingBuffer<value_type>  m_history;      //< Last order velocities, keyed by the step taken from them
+        std::vector<value_type> m_stage[3];     //< Runge-Kutta start up
+
+    public:
+        AdamsBashforth(size_t ode_size) : m_ode_size(ode_size), m_history(order, ode_size) {}
+
+        /**
+         * \brief Forget the velocity history, e.g. after the markers were moved.
+         **/
+        inline void reset() { m_history.clear(); }
+
+        /**
+         * \brief Velocities kept, the current order of the method.
+         **/
+        inline int history_size() const { return int(m_history.size()); }
+
+        /**
+         * \brief Velocity j steps back, 0 is the most recent.
+         **/
+        inline const value_type *velocity(int j) const { return m_history[j]; }
+
+        /**
+         * \brief Step with the velocity v at x.
+         **/
+        inline void operator()(value_type *x, const value_type *v, value_type dt)
+        {
+            m_history.push(dt, v);
+            value_type w[order];
+            weights(dt, w);
+            for(int j = 0; j < history_size(); ++j)
+            {
+                const value_type *vj = velocity(j);
+                size_t i;
+                #pragma omp parallel for private(i)
+                for(i = 0; i < m_ode_size; ++i)
+                    x[i] += w[j] * vj[i];
+            }
+        }
+
+        /**
+         * \brief Step with v = F(t,x) on entry, v = F(t+dt,x) on return.  The first order-1 steps are
+         *  classical Runge-Kutta steps, so the history is of full order.
+         **/
+        template<typename function_type>
+        inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            if(history_size() < order - 1)
+            {
+                m_history.push(dt, v);
+                runge_kutta(F, t, x, v, dt);
+            }
+            else
+                operator()(x, v, dt);
+            F(t + dt, x, v);
+        }
+
+    private:
+        /**
+         * \brief Integrals over [0,dt] of the Lagrange basis of the past times 0, -dt_1, -dt_1-dt_2...
+         **/
+        void weights(value_type dt, value_type *w) const
+        {
+            int size = history_size();
+            value_type tau[order];
+            tau[0] = 0;
+            for(int j = 1; j < size; ++j)
+                tau[j] = tau[j - 1] - m_history.key(j);
+            for(int j = 0; j < size; ++j)
+            {
+                /// Coefficients of l_j(s) in powers of s
+                value_type c[order] = {1}, denominator = 1;
+                int degree = 0;
+                for(int m = 0; m < size; ++m)
+                {
+                    if(m == j)
+                        continue;
+                    for(int p = ++degree; p > 0; --p)
+                        c[p] = c[p - 1] - tau[m] * c[p];
+                    c[0] *= -tau[m];
+                    denominator *= tau[j] - tau[m];
+                }
+                value_type integral = 0, power = dt;
+                for(int p = 0; p <= degree; ++p, power *= dt)
+                    integral += c[p] * power / (p + 1);
+                w[j] = integral / denominator;
+            }
+        }
+
+        template<typename function_type>
+        void runge_kutta(function_type &F, value_type t, value_type *x, const value_type *v, value_type dt)
+        {
+            for(int s = 0; s < 3; ++s)
+                m_stage[s].resize(m_ode_size);
+            value_type *x0 = &m_stage[0][0], *k = &m_stage[1][0], *sum = &m_stage[2][0];
+            std::copy(x, x + m_ode_size, x0);
+            std::copy(v, v + m_ode_size, sum);
+            const value_type c[3] = {.5, .5, 1}, b[3] = {2, 2, 1};
+            const value_type *ks = v;
+            for(int s = 0; s < 3; ++s)
+            {
+                for(size_t i = 0; i < m_ode_size; ++i)
+                    x[i] = x0[i] + c[s] * dt * ks[i];
+                F(t + c[s] * dt, x, k);
+                for(size_t i = 0; i < m_ode_size; ++i)
+                    sum[i] += b[s] * k[i];
+                ks = k;
+            }
+            for(size_t i = 0; i < m_ode_size; ++i)
+                x[i] = x0[i] + dt / 6 * sum[i];
+        }
+};
+
+#endif
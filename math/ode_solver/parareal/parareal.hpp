@@ -0,0 +1,244 @@
+#ifndef PARAREAL_HPP
+#define PARAREAL_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<vector>
+#include<map>
+#include<string>
+#include<algorithm>
+
+/**
+ * \brief Parareal, parallel in time driver.
+ *
+ *  A window of num_slices time slices is advanced at once.  Each slice is slice_steps steps of
+ *  the fine propagator (e.g. ExplicitSDC or SemiImplicitSDC) and coarse_steps steps of the coarse
+ *  propagator.  Every iteration runs the fine propagator on all the unconverged slices
+ *  concurrently, one OpenMP thread per slice, and then corrects serially with the coarse one,
+ *
+ *      U_{s+1} = G(U_s) + F(U_s^old) - G(U_s^old).
+ *
+ *  The slices behind the iteration count are exact, so num_slices iterations reproduce serial
+ *  stepping.  The speedup is at most num_slices/iterations, minus the coarse cost.  Inner OpenMP
+ *  loops of the fine propagator give each slice a thread group when nested parallelism is
+ *  enabled (OMP_NESTED=true).
+ *
+ *  Propagators are functors prop(F,t,x,v,dt) that take v = F(t,x) on entry, return the new
+ *  velocity in v and have a reset() method.  Each slice owns its fine propagator.  The right hand
+ *  side F(t,x,v) of each slice is passed separately since particle systems keep state in it.
+ *
+ * \param fine_propagator_type Fine, accurate propagator.  Constructible from the ode size.
+ * \param coarse_propagator_type Coarse, cheap propagator.  Constructible from the ode size.
+ **/
+template<typename value_type, typename fine_propagator_type, typename coarse_propagator_type>
+class Parareal
+{
+    private:
+        size_t                              m_ode_size;
+        int                                 m_num_slices;
+        int                                 m_slice_steps;
+        int                                 m_coarse_steps;
+        int                                 m_max_iterations;
+        value_type                          m_tolerance;
+        bool                                m_serial_check;
+        value_type                          m_serial_difference;
+        std::vector<fine_propagator_type*>  m_fine;
+        coarse_propagator_type              m_coarse;
+        std::vector<value_type>             m_u;            //< Slice initial values, num_slices+1 of them
+        std::vector<value_type>             m_u_old;
+        std::vector<value_type>             m_fine_values;  //< F(U_s^old) at the end of every slice
+        std::vector<value_type>             m_coarse_values;//< G(U_s^old) at the end of every slice
+        std::vector<value_type>             m_x;            //< Working state of every slice
+        std::vector<value_type>             m_v;
+        std::map<std::string, std::vector<value_type> > *m_stats;
+
+    public:
+        Parareal(size_t ode_size, int num_slices, int slice_steps, int coarse_steps = 1) :
+                m_ode_size(ode_size),
+                m_num_slices(num_slices),
+                m_slice_steps(slice_steps),
+                m_coarse_steps(coarse_steps),
+                m_max_iterations(num_slices),
+                m_tolerance(value_type(1e-10)),
+                m_serial_check(false),
+                m_serial_difference(0),
+                m_fine(num_slices),
+                m_coarse(ode_size),
+                m_u((num_slices + 1) * ode_size),
+                m_u_old((num_slices + 1) * ode_size),
+                m_fine_values(num_slices * ode_size),
+                m_coarse_values(num_slices * ode_size),
+                m_x(num_slices * ode_size),
+                m_v(num_slices * ode_size),
+                m_stats(0)
+        {
+            for(int s = 0; s < num_slices; ++s)
+                m_fine[s] = new fine_propagator_type(ode_size);
+        }
+
+        ~Parareal()
+        {
+            for(int s = 0; s < m_num_slices; ++s)
+                delete m_fine[s];
+        }
+
+        inline int num_slices() { return m_num_slices; }
+        inline void setMaxIterations(int iterations) { m_max_iterations = std::min(iterations, m_num_slices); }
+        inline void setStatistics(std::map<std::string, std::vector<value_type> > *stats) { m_stats = stats; }
+        inline fine_propagator_type &fine_propagator(int s) { return *m_fine[s]; }
+        inline coarse_propagator_type &coarse_propagator() { return m_coarse; }
+
+        /**
+         * \brief Iterations stop when no slice value changes more than tol*(1 + max|U|).
+         **/
+        inline void setTolerance(value_type tol) { m_tolerance = tol; }
+
+        /**
+         * \brief Also step the window serially with the fine propagator and record the largest
+         *  difference with the parareal solution.  Meant for validation, it costs a serial run.
+         **/
+        inline void setSerialCheck(bool check) { m_serial_check = check; }
+        inline value_type serial_difference() const { return m_serial_difference; }
+
+        /**
+         * \brief Length of the window advanced by one call.
+         **/
+        inline value_type window(value_type dt) { return dt * m_slice_steps * m_num_slices; }
+
+        /**
+         * \brief Advances num_slices*slice_steps fine steps with the same right hand side for all slices.
+         *  F has to be safe to call concurrently.
+         **/
+        template<typename function_type>
+        inline int operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            std::vector<function_type*> functions(m_num_slices, &F);
+            return operator()(&functions[0], t, x, v, dt);
+        }
+
+        /**
+         * \brief Advances num_slices*slice_steps fine steps.
+         *
+         * \param F Right hand sides, F[s] is used by slice s and F[0] by the coarse propagator.
+         * \param x Initial value, overwritten by the value at the end of the window.
+         * \param v Velocity at the end of the window.
+         * \param dt Fine time step.
+         * \return Number of iterations.
+         **/
+        template<typename function_type>
+        int operator()(function_type **F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            size_t N = m_ode_size;
+            value_type slice_length = dt * m_slice_steps;
+            std::copy(x, x + N, m_u.begin());
+
+            /// Serial coarse prediction
+            for(int s = 0; s < m_num_slices; ++s)
+            {
+                coarse(*F[0], t + s * slice_length, &m_u[s * N], &m_coarse_values[s * N], slice_length);
+                std::copy(&m_coarse_values[s * N], &m_coarse_values[s * N] + N, &m_u[(s + 1) * N]);
+            }
+
+            int k = 0;
+            value_type defect = value_type(0);
+            while(k < m_max_iterations)
+            {
+                /// Slices before k are converged
+                #pragma omp parallel for schedule(static,1) num_threads(m_num_slices)
+                for(int s = k; s < m_num_slices; ++s)
+                    fine(*F[s], s, t + s * slice_length, &m_u[s * N], &m_fine_values[s * N], dt);
+
+                std::copy(m_u.begin(), m_u.end(), m_u_old.begin());
+                value_type *g = &m_x[0];
+                for(int s = k; s < m_num_slices; ++s)
+                {
+                    coarse(*F[0], t + s * slice_length, &m_u[s * N], g, slice_length);
+                    value_type *u = &m_u[(s + 1) * N], *f = &m_fine_values[s * N], *g_old = &m_coarse_values[s * N];
+                    for(size_t i = 0; i < N; ++i)
+                    {
+                        u[i] = g[i] + f[i] - g_old[i];
+                        g_old[i] = g[i];
+                    }
+                }
+                ++k;
+
+                value_type change = value_type(0), scale = value_type(0);
+                for(size_t i = k * N; i < m_u.size(); ++i)
+                {
+                    change = std::max(change, std::fabs(m_u[i] - m_u_old[i]));
+                    scale = std::max(scale, std::fabs(m_u[i]));
+                }
+                defect = change / (1 + scale);
+                if(m_stats)
+                    (*m_stats)["parareal_defect"].push_back(defect);
+                if(defect <= m_tolerance)
+                    break;
+            }
+
+            value_type *u_end = &m_u[m_num_slices * N];
+            if(m_serial_check)
+            {
+                value_type *y = &m_x[0], *w = &m_v[0];
+                std::copy(m_u.begin(), m_u.begin() + N, y);
+                m_fine[0]->reset();
+                (*F[0])(t, y, w);
+                for(int i = 0; i < m_slice_steps * m_num_slices; ++i)
+                    (*m_fine[0])(*F[0], t + i * dt, y, w, dt);
+                m_serial_difference = value_type(0);
+                for(size_t i = 0; i < N; ++i)
+                    m_serial_difference = std::max(m_serial_difference, std::fabs(y[i] - u_end[i]));
+                if(m_stats)
+                    (*m_stats)["parareal_serial_difference"].push_back(m_serial_difference);
+            }
+            if(m_stats)
+                (*m_stats)["parareal_iterations"].push_back(k);
+
+            std::copy(u_end, u_end + N, x);
+            (*F[0])(t + m_num_slices * slice_length, x, v);
+            return k;
+        }
+
+    private:
+        /**
+         * \brief Fine propagation of slice s from u, the result goes to y.
+         **/
+        template<typename function_type>
+        void fine(function_type &F, int s, value_type t, const value_type *u, value_type *y, value_type dt)
+        {
+            value_type *w = &m_v[s * m_ode_size];
+            std::copy(u, u + m_ode_size, y);
+            m_fine[s]->reset();
+            F(t, y, w);
+            for(int i = 0; i < m_slice_steps; ++i)
+                (*m_fine[s])(F, t + i * dt, y, w, dt);
+        }
+
+        template<typename function_type>
+        void coarse(function_type &F, value_type t, const value_type *u, value_type *y, value_type slice_length)
+        {
+            value_type *w = &m_v[0];
+            value_type dt = slice_length / m_coarse_steps;
+            std::copy(u, u + m_ode_size, y);
+            m_coarse.reset();
+            F(t, y, w);
+            for(int i = 0; i < m_coarse_steps; ++i)
+                m_coarse(F, t + i * dt, y, w, dt);
+        }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef DENSE_OUTPUT_HPP
+#define DENSE_OUTPUT_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+#include<cassert>
+
+#include "math/ode_solver/sdc/integrator/lagrange_polynomial.hpp"
+
+/**
+ * \brief Dense output of an SDC step, the collocation interpolant
+ *
+ *      x(t_0 + s*Dt) = x_0 + Dt*sum_j int_0^s l_j F_j,
+ *
+ *  l_j being the Lagrange basis of the rule's interpolation nodes.  At the nodes it agrees with
+ *  the node values up to the sweep residual.  The values at the first node are overwritten by the
+ *  end of the step, so they are saved when the step starts.  One right hand side (ExplicitSDC) or
+ *  the sum of two (SemiImplicitSDC) is interpolated.
+ **/
+template<typename value_type, typename spectral_integrator_type>
+class DenseOutput
+{
+    public:
+        enum
+        {
+            sdc_nodes = spectral_integrator_type::sdc_nodes,
+            first_basis_node = spectral_integrator_type::first_basis_node,
+            basis_size = sdc_nodes - first_basis_node
+        };
+
+    private:
+        bool                            m_enabled;
+        size_t                          m_ode_size;
+        value_type                      m_t0;
+        value_type                      m_dt;
+        std::vector<value_type>         m_x0;
+        std::vector<value_type>         m_f0[2];
+        LagrangePolynomial<value_type>  m_basis;
+
+    public:
+        DenseOutput() : m_enabled(false), m_ode_size(0), m_t0(0), m_dt(0), m_basis(&basis_nodes()[0], basis_size) {}
+
+        inline bool enabled() const { return m_enabled; }
+        inline value_type start_time() const { return m_t0; }
+        inline value_type end_time() const { return m_t0 + m_dt; }
+
+        /**
+         * \brief Allocates the copies of the first node values.  Disabled objects cost nothing.
+         **/
+        void enable(size_t ode_size, bool enable)
+        {
+            m_enabled = enable;
+            m_ode_size = ode_size;
+            m_x0.resize(enable ? ode_size : 0);
+            m_f0[0].resize(enable ? ode_size : 0);
+            m_f0[1].resize(enable ? ode_size : 0);
+        }
+
+        /**
+         * \brief Saves the first node of the step [t,t+dt].
+         **/
+        void start(value_type t, value_type dt, const value_type *x0, const value_type *f0, const value_type *g0 = 0)
+        {
+            m_t0 = t;
+            m_dt = dt;
+            std::copy(x0, x0 + m_ode_size, m_x0.begin());
+            std::copy(f0, f0 + m_ode_size, m_f0[0].begin());
+            if(g0)
+                std::copy(g0, g0 + m_ode_size, m_f0[1].begin());
+        }
+
+        /**
+         * \brief Evaluates the interpolant at t.
+         *
+         * \param F Right hand sides at the nodes, F[0] is not read.
+         * \param G Second right hand side added to F, or 0.
+         **/
+        void operator()(value_type t, value_type *x, value_type **F, value_type **G = 0) const
+        {
+            assert(m_enabled && t >= m_t0 - 1e-12 * m_dt && t <= m_t0 + m_dt * (1 + 1e-12));
+            value_type s = (t - m_t0) / m_dt;
+            std::copy(m_x0.begin(), m_x0.end(), x);
+            for(int j = 0; j < basis_size; ++j)
+            {
+                int n = j + first_basis_node;
+                value_type w = m_dt * m_basis.integral(j, value_type(0), s);
+                const value_type *f = n > 0 ? F[n] : &m_f0[0][0];
+                for(size_t i = 0; i < m_ode_size; ++i)
+                    x[i] += w * f[i];
+                if(!G)
+                    continue;
+                const value_type *g = n > 0 ? G[n] : &m_f0[1][0];
+                for(size_t i = 0; i < m_ode_size; ++i)
+                    x[i] += w * g[i];
+            }
+        }
+
+    private:
+        static std::vector<value_type> basis_nodes()
+        {
+            spectral_integrator_type rule;
+            std::vector<value_type> nodes(basis_size);
+            for(int j = 0; j < basis_size; ++j)
+                nodes[j] = rule.node(j + first_basis_node);
+            return nodes;
+        }
+};
+
+#endif
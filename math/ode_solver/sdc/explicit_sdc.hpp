@@ -22,6 +22,7 @@
 #include "math/ode_solver/sdc/sdc_storage.hpp"
 #include "math/ode_solver/euler/forward_euler.hpp"
 #include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/dense_output.hpp"
 
 /**
  * \brief This class implements a fully explicit SDC method.
@@ -41,6 +42,7 @@ class ExplicitSDC : public SDCBase<ExplicitSDC<value_type,spectral_integrator_ty
         spectral_integrator_type m_integrator;
         ForwardEuler m_euler_solver;
         /**< This is the integrator used to compute the spectral integrals of the right hand sides F. **/
+        DenseOutput<value_type, spectral_integrator_type> m_dense_output;
 
     public:
 
@@ -62,12 +64,30 @@ class ExplicitSDC : public SDCBase<ExplicitSDC<value_type,spectral_integrator_ty
         inline value_type dt(int i)              { return m_integrator.dt(i); }
         inline value_type &Immk(int i, int j)    { return m_integrator.Immk[i][j]; }
         inline void integrate(value_type Dt)     { m_integrator.integrate(F(), Dt); }
+        inline value_type *workspace(int i)      { return m_integrator.workspace(i); }
         inline size_t ode_size()                 { return m_storage.ode_size; }
 
+        /**
+         * \brief Nothing to reset, the right hand side at the first node is the caller's velocity.
+         **/
+        inline void reset() {}
+
         inline void init(value_type *x, value_type *Fx) { m_storage.init(x, Fx); }
         inline void setX0(value_type *x) { m_storage.setX0(x); }
         inline void setF0(value_type *Fx) { m_storage.setF0(Fx); }
 
+        /**
+         * \brief Keep what dense_output() needs, a copy of the first node of every step.
+         **/
+        inline void setDenseOutput(bool enable) { m_dense_output.enable(m_storage.ode_size, enable); }
+
+        /**
+         * \brief Solution at any time t inside the last step from the collocation interpolant, so
+         *  output times do not restrict the step size.  Requires setDenseOutput(true).
+         **/
+        inline void dense_output(value_type t, value_type *x) { m_dense_output(t, x, F()); }
+        inline const DenseOutput<value_type, spectral_integrator_type> &dense_output() const { return m_dense_output; }
+
         template<typename function_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *xold, value_type *v, value_type *vold, value_type dt)
         {
@@ -75,20 +95,36 @@ class ExplicitSDC : public SDCBase<ExplicitSDC<value_type,spectral_integrator_ty
             setF0(v);
             std::copy(xold, xold + m_storage.ode_size, x);
             std::copy(vold, vold + m_storage.ode_size, v);
-            predictor(F,t,dt);
-            corrector(F,t,dt);
+            if(m_dense_output.enabled())
+                m_dense_output.start(t, dt, x, v);
+            this->predictor(F,t,dt);
+            this->corrector(F,t,dt);
             update();
         }
 
         template<typename function_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            begin(F, t, x, v, dt);
+            while(this->resume(F))
+                ;
+        }
+
+        /**
+         * \brief Start a step that is taken piecewise by resume(), see SDCBase::begin_step().  x and
+         *  v are updated by the last call to resume().
+         **/
+        template<typename function_type>
+        inline void begin(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
         {
             setX0(x);
             setF0(v);
-            predictor(F,t,dt);
-            corrector(F,t,dt);
-            update();
+            if(m_dense_output.enabled())
+                m_dense_output.start(t, dt, x, v);
+            this->begin_step(F, t, dt);
         }
+
+        inline void end_step() { update(); }
         /**
         * \brief The predictor steps updates xnew and and Fnew by applying forward Euler's method
         *
@@ -128,12 +164,12 @@ class ExplicitSDC : public SDCBase<ExplicitSDC<value_type,spectral_integrator_ty
         inline void corrector_predictor_step(function_type &G, const int k, value_type *fdiff, value_type &t, const value_type &dt)
         {
             assert(k < spectral_integrator_type::sdc_nodes);
-            std::vector<value_type> Fold(m_storage.ode_size, 0.0);
-            std::copy(F(k + 1), F(k + 1) + m_storage.ode_size, Fold.begin());
+            value_type *Fold = workspace(1);
+            std::copy(F(k + 1), F(k + 1) + m_storage.ode_size, Fold);
             m_euler_solver(X(k + 1), X(k), fdiff, dt);
             t += dt;
             G(t, X(k + 1), F(k + 1));
-            std::transform(F(k + 1), F(k + 1) + m_storage.ode_size, Fold.begin(), fdiff, std::minus<value_type>());
+            std::transform(F(k + 1), F(k + 1) + m_storage.ode_size, Fold, fdiff, std::minus<value_type>());
         }
 
 };
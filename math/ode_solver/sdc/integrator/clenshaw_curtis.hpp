@@ -288,6 +288,11 @@ namespace detail{
 template<typename value_type, int sdc_nodes>
 struct ClenshawCurtis
 {
+    /**
+     * \brief The interpolating polynomial of the rule uses all the nodes.
+     **/
+    enum { first_basis_node = 0 };
+
     inline value_type matrix(int i, int j)
     {
         assert(i < sdc_nodes-1 && j < sdc_nodes);
@@ -290,6 +290,11 @@ namespace detail{
 template<typename value_type, int sdc_nodes>
 struct GaussRadau
 {
+    /**
+     * \brief The interpolating polynomial of the rule skips the first node, t = 0 is not a Radau node.
+     **/
+    enum { first_basis_node = 1 };
+
     inline value_type matrix(int i, int j)
     {
         assert(i < sdc_nodes-1 && j < sdc_nodes);
@@ -0,0 +1,93 @@
+#ifndef LAGRANGE_POLYNOMIAL_HPP
+#define LAGRANGE_POLYNOMIAL_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<cassert>
+
+/**
+ * \brief Lagrange basis polynomials on a set of nodes.
+ *
+ *  l_j(s) = prod_{i != j} (s - s_i)/(s_j - s_i).  The monomial coefficients are computed once
+ *  in long double, they are only meant for the small number of nodes used by the SDC rules.
+ **/
+template<typename value_type>
+class LagrangePolynomial
+{
+    private:
+        int                         m_size;
+        std::vector<long double>    m_coefficients;     //< Row j holds the coefficients of l_j, lowest degree first
+
+    public:
+        template<typename node_type>
+        LagrangePolynomial(const node_type *nodes, int size) : m_size(size), m_coefficients(size * size, 0.0L)
+        {
+            for(int j = 0; j < size; ++j)
+            {
+                long double *c = &m_coefficients[j * size];
+                c[0] = 1.0L;
+                int degree = 0;
+                for(int i = 0; i < size; ++i)
+                {
+                    if(i == j)
+                        continue;
+                    long double d = 1.0L / (static_cast<long double>(nodes[j]) - nodes[i]);
+                    long double s = static_cast<long double>(nodes[i]);
+                    /// c(x) <- c(x)*(x - s_i)/(s_j - s_i)
+                    ++degree;
+                    c[degree] = 0.0L;
+                    for(int k = degree; k > 0; --k)
+                        c[k] = (c[k - 1] - s * c[k]) * d;
+                    c[0] *= -s * d;
+                }
+            }
+        }
+
+        inline int size() const { return m_size; }
+
+        /**
+         * \brief Value of l_j at s.
+         **/
+        inline value_type operator()(int j, value_type s) const
+        {
+            assert(j < m_size);
+            const long double *c = &m_coefficients[j * m_size];
+            long double p = 0.0L;
+            for(int k = m_size - 1; k >= 0; --k)
+                p = p * s + c[k];
+            return static_cast<value_type>(p);
+        }
+
+        /**
+         * \brief Integral of l_j from a to b.
+         **/
+        inline value_type integral(int j, value_type a, value_type b) const
+        {
+            assert(j < m_size);
+            const long double *c = &m_coefficients[j * m_size];
+            long double pa = 0.0L, pb = 0.0L;
+            for(int k = m_size - 1; k >= 0; --k)
+            {
+                pa = (pa + c[k] / (k + 1)) * a;
+                pb = (pb + c[k] / (k + 1)) * b;
+            }
+            return static_cast<value_type>(pb - pa);
+        }
+};
+
+#endif
@@ -18,40 +18,166 @@
 ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****************************************************************************/
 #include<vector>
+#include "utils/aligned_allocator.hpp"
 #include "quadrature_rule.hpp"
+#include "lagrange_polynomial.hpp"
 
+namespace detail
+{
+    /**
+     * \brief Compile time unrolled accumulation of one row of the integration matrix,
+     *  s += sum_j c[i][j]*f[j], in increasing j.
+     **/
+    template<typename value_type, int sdc_nodes, int i, int j = 0>
+    struct integration_row
+    {
+        static inline void accumulate(value_type &s, const value_type *c, const value_type *f)
+        {
+            s += f[j] * c[i * sdc_nodes + j];
+            integration_row<value_type, sdc_nodes, i, j + 1>::accumulate(s, c, f);
+        }
+    };
+
+    template<typename value_type, int sdc_nodes, int i>
+    struct integration_row<value_type, sdc_nodes, i, sdc_nodes>
+    {
+        static inline void accumulate(value_type &, const value_type *, const value_type *) {}
+    };
+
+    /**
+     * \brief Compile time unrolled product of the integration matrix with the node values
+     *  of one component, I[i][k] = sum_j c[i][j]*f[j] for all rows i.
+     **/
+    template<typename value_type, int sdc_nodes, int i = 0, bool done = (i == sdc_nodes - 1)>
+    struct integration_rows
+    {
+        static inline void apply(const value_type *c, const value_type *f, value_type **I, size_t k)
+        {
+            value_type s = value_type(0);
+            integration_row<value_type, sdc_nodes, i>::accumulate(s, c, f);
+            I[i][k] = s;
+            integration_rows<value_type, sdc_nodes, i + 1>::apply(c, f, I, k);
+        }
+    };
+
+    template<typename value_type, int sdc_nodes, int i>
+    struct integration_rows<value_type, sdc_nodes, i, true>
+    {
+        static inline void apply(const value_type *, const value_type *, value_type **, size_t) {}
+    };
+}
+
+/**
+ * \brief Multirate spectral integrator.  Every interval between two sdc nodes is subdivided by the
+ *  multirate_nodes nodes of the same quadrature rule, which gives total_nodes fine nodes.
+ *
+ *  The slow right hand side Fs is known at the sdc nodes and is integrated over every fine interval
+ *  with its Lagrange interpolant.  The fast right hand side Ff is known at all the fine nodes and is
+ *  integrated with the interpolant of the fine nodes of its sdc interval.
+ **/
 template<typename value_type, quadrature_type quadrature, int _sdc_nodes, int _multirate_nodes, int _total_nodes>
 struct SpectralIntegrator
-        : public QuadratureRule<value_type, quadrature, _sdc_nodes, _multirate_nodes>::type
+        : public QuadratureRule<value_type, quadrature, _sdc_nodes, 0>::type
 {
     enum
     {
         sdc_nodes = _sdc_nodes,
         multirate_nodes = _multirate_nodes,
-        total_nodes = _total_nodes
+        total_nodes = _total_nodes,
+        workspace_size = 4
     };
-    value_type &Immk;
-    SpectralIntegrator<value_type, quadrature, total_nodes, 2, total_nodes> sdc_integrator;
 
-    SpectralIntegrator() : Immk(sdc_integrator.Immk)
-    {
-    }
+    typedef std::vector<value_type, AlignedAllocator<value_type> > vector_type;
+    typedef typename QuadratureRule<value_type, quadrature, multirate_nodes, 0>::type fine_rule_type;
 
+    vector_type Immk[sdc_nodes - 1];            //< Integrals between sdc nodes
+    vector_type Iqq[total_nodes - 1];           //< Integrals between fine nodes
+    vector_type m_workspace[workspace_size];    //< Scratch vectors for the SDC sweeps
+    value_type m_slow_matrix[(total_nodes - 1) * sdc_nodes];
+    value_type m_fast_matrix[(multirate_nodes - 1) * multirate_nodes];
+    value_type m_fine_dt[multirate_nodes - 1];
+    size_t ode_size;
+
+    /**
+     * \brief Allocates all the storage used during a time step and computes the integration matrices.
+     **/
     void init(size_t _ode_size)
     {
-        sdc_integrator.init(_ode_size);
+        for(int i = 0; i < sdc_nodes - 1; ++i)
+            Immk[i].resize(_ode_size, 0.0);
+        for(int i = 0; i < total_nodes - 1; ++i)
+            Iqq[i].resize(_ode_size, 0.0);
+        for(int i = 0; i < workspace_size; ++i)
+            m_workspace[i].resize(_ode_size, 0.0);
+
+        fine_rule_type fine_rule;
+        value_type nodes[sdc_nodes];
+        for(int j = 0; j < sdc_nodes; ++j)
+            nodes[j] = this->node(j);
+        LagrangePolynomial<value_type> lagrange(nodes, sdc_nodes);
+        for(int m = 0; m < sdc_nodes - 1; ++m)
+            for(int p = 0; p < multirate_nodes - 1; ++p)
+            {
+                value_type a = nodes[m] + this->dt(m) * fine_rule.node(p);
+                value_type b = nodes[m] + this->dt(m) * fine_rule.node(p + 1);
+                for(int j = 0; j < sdc_nodes; ++j)
+                    m_slow_matrix[(m * (multirate_nodes - 1) + p) * sdc_nodes + j] = lagrange.integral(j, a, b);
+            }
+        for(int p = 0; p < multirate_nodes - 1; ++p)
+        {
+            m_fine_dt[p] = fine_rule.dt(p);
+            for(int j = 0; j < multirate_nodes; ++j)
+                m_fast_matrix[p * multirate_nodes + j] = fine_rule.matrix(p, j);
+        }
+        ode_size = _ode_size;
     }
 
-    inline void integrate(const value_type *F1, const value_type *F2, value_type Dt)
+    inline value_type *workspace(int i) { return &m_workspace[i][0]; }
+
+    /**
+     * \brief Length of the fine interval p relative to its sdc interval.
+     **/
+    inline value_type fine_dt(int p) { return m_fine_dt[p]; }
+
+    /**
+     * \brief Computes the fine integrals Iqq and the sdc node integrals Immk of Fs + Ff in one pass.
+     *
+     * \param Fs Slow right hand side at the sdc nodes.
+     * \param Ff Fast right hand side at the fine nodes.
+     **/
+    inline void integrate(value_type **Fs, value_type **Ff, value_type Dt)
     {
-        sdc_integrator.integrate(F1, Dt);
-        for(int i = 0; i < total_nodes - 1; ++i)
+        value_type fast_scale[sdc_nodes - 1];
+        for(int m = 0; m < sdc_nodes - 1; ++m)
+            fast_scale[m] = this->dt(m) * Dt;
+        size_t k;
+        #pragma omp parallel for private(k)
+        for(k = 0; k < ode_size; ++k)
+        {
+            value_type fs[sdc_nodes];
             for(int j = 0; j < sdc_nodes; ++j)
+                fs[j] = Fs[j][k];
+            for(int m = 0; m < sdc_nodes - 1; ++m)
             {
-                value_type c = this->matrix(i, j) * Dt;
-                for(size_t k = 0; k < sdc_integrator.ode_size; ++k)
-                    Immk[i][k] += F2[j][k] * c;
+                value_type ff[multirate_nodes];
+                for(int j = 0; j < multirate_nodes; ++j)
+                    ff[j] = Ff[m * (multirate_nodes - 1) + j][k];
+                value_type sum = value_type(0);
+                for(int p = 0; p < multirate_nodes - 1; ++p)
+                {
+                    int q = m * (multirate_nodes - 1) + p;
+                    value_type slow = value_type(0), fast = value_type(0);
+                    for(int j = 0; j < sdc_nodes; ++j)
+                        slow += m_slow_matrix[q * sdc_nodes + j] * fs[j];
+                    for(int j = 0; j < multirate_nodes; ++j)
+                        fast += m_fast_matrix[p * multirate_nodes + j] * ff[j];
+                    value_type I = slow * Dt + fast * fast_scale[m];
+                    Iqq[q][k] = I;
+                    sum += I;
+                }
+                Immk[m][k] = sum;
             }
+        }
     }
 };
 
@@ -62,49 +188,78 @@ struct SpectralIntegrator<value_type, quadrature, _sdc_nodes, 2, _sdc_nodes>
 {
     enum
     {
-        sdc_nodes = _sdc_nodes
+        sdc_nodes = _sdc_nodes,
+        workspace_size = 3
     };
 
-    std::vector<value_type> Immk[sdc_nodes - 1];
+    typedef std::vector<value_type, AlignedAllocator<value_type> > vector_type;
+
+    vector_type Immk[sdc_nodes - 1];
+    vector_type m_workspace[workspace_size];    //< Scratch vectors for the SDC sweeps
+    value_type m_matrix[(sdc_nodes - 1) * sdc_nodes];
     size_t ode_size;
 
+    /**
+     * \brief Allocates all the storage used during a time step.  Stepping does not allocate afterwards.
+     **/
     void init(size_t _ode_size)
     {
         for(int i = 0; i < sdc_nodes-1; ++i)
             Immk[i].resize(_ode_size,0.0);
+        for(int i = 0; i < workspace_size; ++i)
+            m_workspace[i].resize(_ode_size,0.0);
+        for(int i = 0; i < sdc_nodes - 1; ++i)
+            for(int j = 0; j < sdc_nodes; ++j)
+                m_matrix[i * sdc_nodes + j] = this->matrix(i, j);
         ode_size = _ode_size;
     }
 
+    /**
+     * \brief Scratch vector of size ode_size.  Index 0 holds the corrector's integral
+     *  differences, index 1 is free for the substeps and index 2 keeps the end value of
+     *  the previous sweep.
+     **/
+    inline value_type *workspace(int i) { return &m_workspace[i][0]; }
+
+    /**
+     * \brief Computes the node to node integrals Immk of F.  Each component is read once and
+     *  all the integrals are written in the same pass.
+     **/
     inline void integrate(value_type **F, value_type Dt)
     {
-        for(int i = 0; i < sdc_nodes - 1; ++i)
+        value_type c[(sdc_nodes - 1) * sdc_nodes];
+        value_type *I[sdc_nodes - 1];
+        scale(c, I, Dt);
+        size_t k;
+        #pragma omp parallel for private(k)
+        for(k = 0; k < ode_size; ++k)
         {
-            std::fill(Immk[i].begin(), Immk[i].end(), value_type(0));
+            value_type f[sdc_nodes];
             for(int j = 0; j < sdc_nodes; ++j)
-            {
-                value_type c = this->matrix(i,j) * Dt;
-                for(size_t k = 0; k < ode_size; ++k)
-                    Immk[i][k] += F[j][k] * c;
-            }
+                f[j] = F[j][k];
+            detail::integration_rows<value_type, sdc_nodes>::apply(c, f, I, k);
         }
     }
 
+    /**
+     * \brief Computes the node to node integrals Immk of F1 + F2 in one pass.
+     **/
     inline void integrate(value_type **F1, value_type **F2, value_type Dt)
     {
-        // TODO: Fix me, inefficient!
-        value_type *F[sdc_nodes];
-        for(int i = 0; i < sdc_nodes; ++i)
-            F[i] = new value_type[ode_size];
-        for(int i = 0; i < sdc_nodes; ++i)
+        value_type c[(sdc_nodes - 1) * sdc_nodes];
+        value_type *I[sdc_nodes - 1];
+        scale(c, I, Dt);
+        size_t k;
+        #pragma omp parallel for private(k)
+        for(k = 0; k < ode_size; ++k)
         {
-            for(size_t k = 0; k < ode_size; ++k)
-                F[i][k] = F1[i][k] + F2[i][k];
-            //             std::copy(F[i],F[i]+ode_size,std::ostream_iterator<value_type>(std::cout, " "));std::cout << std::endl;
+            value_type f[sdc_nodes];
+            for(int j = 0; j < sdc_nodes; ++j)
+                f[j] = F1[j][k] + F2[j][k];
+            detail::integration_rows<value_type, sdc_nodes>::apply(c, f, I, k);
         }
-        integrate(F, Dt);
-        for(size_t i = 0; i < sdc_nodes; ++i)
-            delete [] F[i];
     }
+
     inline void integrate(const value_type **F1, const value_type **F2, const value_type **F3, value_type Dt)
     {
         // TODO: Fix me, inefficient!
@@ -132,6 +287,17 @@ struct SpectralIntegrator<value_type, quadrature, _sdc_nodes, 2, _sdc_nodes>
                 F[i][k] = F1[i][k] + F2[i][k];
         integrate(F, F3, F4, F5, Dt);
     }
+
+    /**
+     * \brief Integration matrix scaled by the time step and pointers to the outputs.
+     **/
+    inline void scale(value_type *c, value_type **I, value_type Dt)
+    {
+        for(int i = 0; i < (sdc_nodes - 1) * sdc_nodes; ++i)
+            c[i] = m_matrix[i] * Dt;
+        for(int i = 0; i < sdc_nodes - 1; ++i)
+            I[i] = &Immk[i][0];
+    }
 };
 
 template < typename value_type, quadrature_type quadrature = other, int sdc_nodes = 5, int multirate_nodes = 2, int total_nodes = (sdc_nodes - 1) * (multirate_nodes - 1) + 1 >
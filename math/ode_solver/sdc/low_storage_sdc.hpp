@@ -0,0 +1,234 @@
+#ifndef LOW_STORAGE_SDC_HPP
+#define LOW_STORAGE_SDC_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+
+/**
+ * \brief Semi-implicit SDC with reduced storage, for state vectors that barely fit in memory.
+ *
+ *  SemiImplicitSDC keeps sdc_nodes-1 states, 2*sdc_nodes right hand sides, sdc_nodes-1 node
+ *  integrals and 3 scratch vectors, 4*sdc_nodes+1 vectors.  Here the node integrals of a sweep
+ *  are written over the old states, which the sweep does not need once the integrals are known,
+ *  and each one is moved to a single vector right before its node is updated.  The implicit
+ *  solves and right hand side evaluations share the substep buffer.  That leaves
+ *  3*sdc_nodes+3 vectors, 18 instead of 21 with 5 nodes.  Both keep a BackwardEuler with its
+ *  Newton and GMRES vectors, the same for both, which storage() does not count.
+ *
+ *  The right hand sides, 2*sdc_nodes of the vectors, can be stored as rhs_type, e.g. float.
+ *  The sweeps then converge to the collocation solution of the rounded right hand sides, an error
+ *  of about Dt*|F| times the float rounding per step, and 5 nodes take as much as 13 double vectors.
+ *
+ *  The sweep is the one of SemiImplicitSDC with the default preconditioner, the Newton solves start
+ *  from the explicit part of the substep instead of the previous sweep.
+ *
+ * \param sdc_corrections Number of corrections to do.
+ * \param rhs_type Storage type of the right hand sides.
+ **/
+template < typename value_type, typename spectral_integrator_type = Integrator<value_type, gauss_lobatto>, int sdc_corrections = 8, typename rhs_type = value_type >
+class LowStorageSDC : public SDCBase<LowStorageSDC<value_type, spectral_integrator_type, sdc_corrections, rhs_type> >
+{
+    protected:
+        typedef BackwardEuler<value_type> backward_euler_type;
+        typedef std::vector<value_type> vector_type;
+        typedef std::vector<rhs_type> rhs_vector_type;
+        enum
+        {
+            sdc_nodes = spectral_integrator_type::sdc_nodes
+        };
+
+    protected:
+        size_t                      m_ode_size;
+        spectral_integrator_type    m_rule;
+        backward_euler_type         m_backward_euler;
+        value_type                  *m_x0;
+        vector_type                 m_x[sdc_nodes - 1];     //< Nodes after the first one, node integrals during a sweep
+        rhs_vector_type             m_fi[sdc_nodes];
+        rhs_vector_type             m_fe[sdc_nodes];
+        vector_type                 m_workspace[3];         //< Corrector differences, substep buffer and previous sweep
+        vector_type                 m_integral;             //< Integral between the nodes of the current substep
+        value_type                  m_matrix[(sdc_nodes - 1) * sdc_nodes];
+        bool                        m_initialized;
+
+    public:
+        LowStorageSDC(size_t ode_size) : m_ode_size(ode_size), m_backward_euler(ode_size), m_x0(0), m_integral(ode_size), m_initialized(false)
+        {
+            for(int k = 0; k < sdc_nodes; ++k)
+            {
+                if(k > 0)
+                    m_x[k - 1].resize(ode_size);
+                m_fi[k].resize(ode_size);
+                m_fe[k].resize(ode_size);
+            }
+            for(int i = 0; i < 3; ++i)
+                m_workspace[i].resize(ode_size);
+            for(int i = 0; i < sdc_nodes - 1; ++i)
+                for(int j = 0; j < sdc_nodes; ++j)
+                    m_matrix[i * sdc_nodes + j] = m_rule.matrix(i, j);
+        }
+
+        inline const value_type* X(int i) const  { return i == 0 ? m_x0 : &m_x[i - 1][0]; }
+        inline value_type* X(int i)              { return i == 0 ? m_x0 : &m_x[i - 1][0]; }
+        inline const rhs_type* Fi(int i) const   { return &m_fi[i][0]; }
+        inline const rhs_type* Fe(int i) const   { return &m_fe[i][0]; }
+        inline value_type dt(int i)              { return m_rule.dt(i); }
+        inline value_type *workspace(int i)      { return &m_workspace[i][0]; }
+        inline size_t ode_size()                 { return m_ode_size; }
+        inline backward_euler_type &implicit_solver() { return m_backward_euler; }
+
+        /**
+         * \brief Integral of the current substep, only valid inside a sweep.
+         **/
+        inline value_type &Immk(int, int j)      { return m_integral[j]; }
+
+        /**
+         * \brief Bytes held by the state, right hand side and scratch vectors, the implicit solver
+         *  is not counted.  Compare with SemiImplicitSDC::storage().
+         **/
+        inline size_t storage() const
+        {
+            return m_ode_size * ((sdc_nodes + 3) * sizeof(value_type) + 2 * sdc_nodes * sizeof(rhs_type));
+        }
+
+        /**
+         * \brief See SemiImplicitSDC::reset().
+         **/
+        inline void reset() { m_initialized = false; }
+
+        template<typename function_type>
+        inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            m_x0 = x;
+            if(!m_initialized)
+            {
+                value_type *buffer = workspace(1);
+                F.Implicit(t, x, buffer);
+                std::copy(buffer, buffer + m_ode_size, m_fi[0].begin());
+                F.Explicit(t, x, buffer);
+                std::copy(buffer, buffer + m_ode_size, m_fe[0].begin());
+                m_initialized = true;
+            }
+            this->predictor(F, t, dt);
+            this->corrector(F, t, dt);
+            update();
+            for(size_t j = 0; j < m_ode_size; ++j)
+                v[j] = value_type(m_fi[0][j]) + value_type(m_fe[0][j]);
+        }
+
+        inline void update()
+        {
+            std::copy(X(sdc_nodes - 1), X(sdc_nodes - 1) + m_ode_size, m_x0);
+            std::copy(m_fi[sdc_nodes - 1].begin(), m_fi[sdc_nodes - 1].end(), m_fi[0].begin());
+            std::copy(m_fe[sdc_nodes - 1].begin(), m_fe[sdc_nodes - 1].end(), m_fe[0].begin());
+        }
+
+        /**
+         * \brief Node integrals of Fi + Fe, the one between the nodes k and k+1 overwrites X(k+1).
+         **/
+        void integrate(value_type Dt)
+        {
+            value_type c[(sdc_nodes - 1) * sdc_nodes];
+            value_type *I[sdc_nodes - 1];
+            for(int i = 0; i < (sdc_nodes - 1) * sdc_nodes; ++i)
+                c[i] = m_matrix[i] * Dt;
+            for(int i = 0; i < sdc_nodes - 1; ++i)
+                I[i] = &m_x[i][0];
+            size_t k;
+            #pragma omp parallel for private(k)
+            for(k = 0; k < m_ode_size; ++k)
+            {
+                value_type f[sdc_nodes];
+                for(int j = 0; j < sdc_nodes; ++j)
+                    f[j] = value_type(m_fi[j][k]) + value_type(m_fe[j][k]);
+                detail::integration_rows<value_type, sdc_nodes>::apply(c, f, I, k);
+            }
+        }
+
+        /**
+         * \brief Moves the integral out of X(k+1) before the substep overwrites it, see
+         *  SDCBase::add_integral().
+         **/
+        inline void add_integral(size_t k, value_type *fdiff, value_type dt)
+        {
+            std::copy(X(k + 1), X(k + 1) + m_ode_size, m_integral.begin());
+            SDCBase<LowStorageSDC>::add_integral(k, fdiff, dt);
+        }
+
+        template<typename function_type>
+        inline void predictor_step(function_type &F, const int k, value_type &t, const value_type &dt)
+        {
+            value_type *buffer = workspace(1);
+            const rhs_type *fe = Fe(k);
+            t += dt;
+            for(size_t j = 0; j < m_ode_size; ++j)
+                buffer[j] = X(k)[j] + dt * value_type(fe[j]);
+            substep(F, k, t, dt, 0);
+        }
+
+        template<typename function_type>
+        inline void corrector_predictor_step(function_type &F, const int k, value_type *fdiff, value_type &t, const value_type &dt)
+        {
+            value_type *buffer = workspace(1);
+            const rhs_type *fi = Fi(k + 1);
+            t += dt;
+            for(size_t j = 0; j < m_ode_size; ++j)
+                buffer[j] = X(k)[j] + dt * (fdiff[j] - value_type(fi[j]));
+            substep(F, k, t, dt, fdiff);
+        }
+
+    private:
+        /**
+         * \brief Solves X(k+1) - dt*Fi(X(k+1)) = buffer and evaluates Fe, fdiff gets the change of Fe.
+         *  The buffer receives each right hand side before it is stored.
+         **/
+        template<typename function_type>
+        inline void substep(function_type &F, const int k, value_type t, value_type dt, value_type *fdiff)
+        {
+            implicit_function<function_type> G(F);
+            value_type *buffer = workspace(1), *x = X(k + 1);
+            std::copy(buffer, buffer + m_ode_size, x);
+            m_backward_euler(G, t, x, buffer, buffer, dt);
+            std::copy(buffer, buffer + m_ode_size, m_fi[k + 1].begin());
+
+            F.Explicit(t, x, buffer);
+            rhs_type *fe = &m_fe[k + 1][0];
+            for(size_t j = 0; j < m_ode_size; ++j)
+            {
+                if(fdiff)
+                    fdiff[j] = buffer[j] - value_type(fe[j]);
+                fe[j] = rhs_type(buffer[j]);
+            }
+        }
+};
+
+template<typename _value_type, typename _integrator_type, int _sdc_corrections, typename _rhs_type>
+struct sdc_traits<LowStorageSDC<_value_type, _integrator_type, _sdc_corrections, _rhs_type> >
+{
+    typedef _value_type value_type;
+    typedef _integrator_type integrator_type;
+    enum
+    {
+        sdc_nodes = _integrator_type::sdc_nodes,
+        sdc_corrections = _sdc_corrections
+    };
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef MULTILEVEL_SDC_HPP
+#define MULTILEVEL_SDC_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/integrator/lagrange_polynomial.hpp"
+
+/**
+ * \brief Two level explicit SDC (MLSDC).  The correction sweeps alternate between the fine level
+ *  and a coarse level with fewer nodes and, optionally, a cheaper right hand side.
+ *
+ *  Every step does a coarse predictor and coarse sweeps, spreads the result to the fine nodes
+ *  and then takes sdc_corrections-1 fine sweeps.  Between two fine sweeps the fine solution is
+ *  restricted to the coarse nodes, coarse_sweeps sweeps are taken with the FAS correction
+ *
+ *      tau_m = int_{t_m}^{t_{m+1}} F_fine - int_{t_m}^{t_{m+1}} G(restricted X),
+ *
+ *  and the coarse corrections of X and F are interpolated back.  The FAS term makes the fine
+ *  collocation solution a fixed point of the coarse sweeps, so a crude coarse model only slows
+ *  convergence down.  For particle systems the near field (see implicit_function) is a cheap
+ *  coarse model.  The levels are ExplicitSDC objects, nodes do not need to be nested.
+ *
+ * \param fine_integrator_type Spectral integrator of the fine level.
+ * \param coarse_integrator_type Spectral integrator of the coarse level.
+ * \param sdc_corrections The number of fine sweeps is sdc_corrections-1.
+ * \param coarse_sweeps Number of coarse sweeps per coarse correction.
+ **/
+template < typename value_type,
+           typename fine_integrator_type = Integrator<value_type, gauss_lobatto, 5>,
+           typename coarse_integrator_type = Integrator<value_type, gauss_lobatto, 3>,
+           int sdc_corrections = 3, int coarse_sweeps = 2 >
+class MultilevelSDC
+{
+    public:
+        typedef ExplicitSDC<value_type, fine_integrator_type, sdc_corrections>      fine_level_type;
+        typedef ExplicitSDC<value_type, coarse_integrator_type, coarse_sweeps + 1>  coarse_level_type;
+
+        enum
+        {
+            fine_nodes = fine_integrator_type::sdc_nodes,
+            coarse_nodes = coarse_integrator_type::sdc_nodes
+        };
+
+    private:
+        size_t                  m_ode_size;
+        fine_level_type         m_fine;
+        coarse_level_type       m_coarse;
+        std::vector<value_type> m_coarse_f0;
+        std::vector<value_type> m_dx[coarse_nodes];     //< Restricted X, then the coarse correction of X
+        std::vector<value_type> m_df[coarse_nodes];     //< Restricted G, then the coarse correction of G
+        std::vector<value_type> m_tau[coarse_nodes - 1];
+        value_type              *m_tau_ptr[coarse_nodes - 1];
+        value_type              m_coarse_node[coarse_nodes];
+        value_type              m_fine_node[fine_nodes];
+        value_type              m_restriction[coarse_nodes * fine_nodes];           //< l_fine_n(s_m)
+        value_type              m_interpolation[fine_nodes * coarse_nodes];         //< l_coarse_m(s_n)
+        value_type              m_fine_integrals[(coarse_nodes - 1) * fine_nodes];  //< int_{s_m}^{s_{m+1}} l_fine_n
+
+    public:
+        MultilevelSDC(size_t ode_size) : m_ode_size(ode_size), m_fine(ode_size), m_coarse(ode_size), m_coarse_f0(ode_size)
+        {
+            for(int m = 0; m < coarse_nodes; ++m)
+            {
+                m_dx[m].resize(ode_size);
+                m_df[m].resize(ode_size);
+            }
+            for(int m = 0; m < coarse_nodes - 1; ++m)
+            {
+                m_tau[m].resize(ode_size);
+                m_tau_ptr[m] = &m_tau[m][0];
+            }
+
+            fine_integrator_type fine_rule;
+            coarse_integrator_type coarse_rule;
+            for(int n = 0; n < fine_nodes; ++n)
+                m_fine_node[n] = fine_rule.node(n);
+            for(int m = 0; m < coarse_nodes; ++m)
+                m_coarse_node[m] = coarse_rule.node(m);
+            LagrangePolynomial<value_type> fine_basis(m_fine_node, fine_nodes), coarse_basis(m_coarse_node, coarse_nodes);
+            for(int m = 0; m < coarse_nodes; ++m)
+                for(int n = 0; n < fine_nodes; ++n)
+                {
+                    m_restriction[m * fine_nodes + n] = fine_basis(n, m_coarse_node[m]);
+                    m_interpolation[n * coarse_nodes + m] = coarse_basis(m, m_fine_node[n]);
+                    if(m < coarse_nodes - 1)
+                        m_fine_integrals[m * fine_nodes + n] = fine_basis.integral(n, m_coarse_node[m], m_coarse_node[m + 1]);
+                }
+        }
+
+        inline fine_level_type &fine_level() { return m_fine; }
+        inline coarse_level_type &coarse_level() { return m_coarse; }
+        inline size_t ode_size() { return m_ode_size; }
+
+        /**
+         * \brief Nothing to reset, the right hand side at the first node is the caller's velocity.
+         **/
+        inline void reset() {}
+
+        /**
+         * \brief Fine solution at the last node before the last fine sweep.
+         **/
+        inline const value_type *previous_sweep() { return m_fine.previous_sweep(); }
+        inline int estimate_order() const { return m_fine.estimate_order(); }
+
+        /**
+         * \brief See SDCBase::setThrowOnDivergence(), it applies to both levels.
+         **/
+        inline void setThrowOnDivergence(bool enable)
+        {
+            m_fine.setThrowOnDivergence(enable);
+            m_coarse.setThrowOnDivergence(enable);
+        }
+        inline bool diverged() const { return m_fine.diverged() || m_coarse.diverged(); }
+
+        /**
+         * \brief Time step where both levels use the same right hand side.
+         **/
+        template<typename function_type>
+        inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            operator()(F, F, t, x, v, dt);
+        }
+
+        /**
+         * \brief Time step.
+         *
+         * \param F Fine right hand side.
+         * \param G Coarse right hand side.
+         * \param x Solution, updated in place.
+         * \param v F(t,x) on entry and at the new time on exit.
+         **/
+        template<typename fine_function_type, typename coarse_function_type>
+        void operator()(fine_function_type &F, coarse_function_type &G, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            m_fine.setX0(x);
+            m_fine.setF0(v);
+            m_coarse.setX0(x);
+            m_coarse.setF0(&m_coarse_f0[0]);
+            G(t, x, &m_coarse_f0[0]);
+
+            m_coarse.predictor(G, t, dt);
+            m_coarse.corrector(G, t, dt);
+            for(int n = 1; n < fine_nodes; ++n)
+            {
+                value_type *xn = m_fine.X(n);
+                std::fill(xn, xn + m_ode_size, value_type(0));
+                for(int m = 0; m < coarse_nodes; ++m)
+                {
+                    value_type c = m_interpolation[n * coarse_nodes + m];
+                    const value_type *xm = m_coarse.X(m);
+                    for(size_t j = 0; j < m_ode_size; ++j)
+                        xn[j] += c * xm[j];
+                }
+                F(t + dt * m_fine_node[n], xn, m_fine.F(n));
+            }
+
+            for(int i = 0; i < sdc_corrections - 1; ++i)
+            {
+                if(i > 0)
+                    coarse_correction(G, t, dt);
+                m_fine.sweep(F, t, dt, i);
+            }
+            m_fine.update();
+        }
+
+    private:
+        /**
+         * \brief Restriction, FAS coarse sweeps and interpolation of the coarse corrections.
+         **/
+        template<typename coarse_function_type>
+        void coarse_correction(coarse_function_type &G, value_type t, value_type dt)
+        {
+            for(int m = 1; m < coarse_nodes; ++m)
+            {
+                value_type *xm = m_coarse.X(m);
+                std::fill(xm, xm + m_ode_size, value_type(0));
+                for(int n = 0; n < fine_nodes; ++n)
+                {
+                    value_type c = m_restriction[m * fine_nodes + n];
+                    const value_type *xn = m_fine.X(n);
+                    for(size_t j = 0; j < m_ode_size; ++j)
+                        xm[j] += c * xn[j];
+                }
+                G(t + dt * m_coarse_node[m], xm, m_coarse.F(m));
+                std::copy(xm, xm + m_ode_size, m_dx[m].begin());
+                std::copy(m_coarse.F(m), m_coarse.F(m) + m_ode_size, m_df[m].begin());
+            }
+
+            m_coarse.integrate(dt);
+            for(int m = 0; m < coarse_nodes - 1; ++m)
+            {
+                value_type *tau = m_tau_ptr[m];
+                for(size_t j = 0; j < m_ode_size; ++j)
+                    tau[j] = -m_coarse.Immk(m, j);
+                for(int n = 0; n < fine_nodes; ++n)
+                {
+                    value_type c = m_fine_integrals[m * fine_nodes + n] * dt;
+                    const value_type *fn = m_fine.F(n);
+                    for(size_t j = 0; j < m_ode_size; ++j)
+                        tau[j] += c * fn[j];
+                }
+            }
+
+            m_coarse.setFAS(m_tau_ptr);
+            m_coarse.corrector(G, t, dt);
+            m_coarse.setFAS(0);
+
+            for(int m = 1; m < coarse_nodes; ++m)
+                for(size_t j = 0; j < m_ode_size; ++j)
+                {
+                    m_dx[m][j] = m_coarse.X(m)[j] - m_dx[m][j];
+                    m_df[m][j] = m_coarse.F(m)[j] - m_df[m][j];
+                }
+            for(int n = 1; n < fine_nodes; ++n)
+            {
+                value_type *xn = m_fine.X(n), *fn = m_fine.F(n);
+                for(int m = 1; m < coarse_nodes; ++m)
+                {
+                    value_type c = m_interpolation[n * coarse_nodes + m];
+                    for(size_t j = 0; j < m_ode_size; ++j)
+                    {
+                        xn[j] += c * m_dx[m][j];
+                        fn[j] += c * m_df[m][j];
+                    }
+                }
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef MULTIRATE_SDC_HPP
+#define MULTIRATE_SDC_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+
+#include "math/ode_solver/sdc/sdc_base.hpp"
+#include "math/ode_solver/sdc/sdc_storage.hpp"
+#include "math/ode_solver/euler/forward_euler.hpp"
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+
+/**
+ * \brief This class implements an explicit multirate SDC method.
+ *
+ *  The right hand side is split as F = F.Explicit + F.Implicit, the same split used by
+ *  SemiImplicitSDC.  Here F.Explicit is the slow, expensive part and it is only evaluated at the
+ *  sdc nodes.  F.Implicit is the fast, cheap and stiff part and it is evaluated at every fine node,
+ *  each sdc interval is subdivided by multirate_nodes nodes.  For particle systems these are the
+ *  far field (N-body) and near field (spring connected particles) velocities of FluidSolver.
+ *
+ *  Every substep is a forward Euler step.  The slow correction is frozen at the left sdc node of
+ *  the interval while the fast correction is updated on every fine node.
+ *
+ * \param spectral_integrator_type A multirate Integrator, e.g. Integrator<value_type,gauss_lobatto,5,3>.
+ * \param sdc_corrections Number of corrections to do.
+ **/
+template < typename value_type, typename spectral_integrator_type = Integrator<value_type, gauss_lobatto, 5, 3>, int sdc_corrections = 8 >
+class MultirateSDC : public SDCBase<MultirateSDC<value_type, spectral_integrator_type, sdc_corrections> >
+{
+    public:
+        enum
+        {
+            sdc_nodes = spectral_integrator_type::sdc_nodes,
+            multirate_nodes = spectral_integrator_type::multirate_nodes,
+            total_nodes = spectral_integrator_type::total_nodes
+        };
+
+    private:
+        internal::sdc_storage < value_type, sdc_nodes,
+                   internal::MULTIRATE, multirate_nodes >       m_storage;
+        spectral_integrator_type                                m_integrator;
+        ForwardEuler                                            m_euler_solver;
+        bool                                                    m_initialized;
+
+    public:
+        MultirateSDC(size_t ode_size) : m_storage(ode_size), m_euler_solver(ode_size), m_initialized(false)
+        {
+            m_integrator.init(ode_size);
+        }
+
+        inline const value_type *Fs(int i) const { return m_storage.Fs()[i]; }
+        inline value_type *Fs(int i)             { return m_storage.Fs()[i]; }
+        inline value_type **Fs()                 { return m_storage.Fs(); }
+        inline const value_type *Ff(int q) const { return m_storage.Ff()[q]; }
+        inline value_type *Ff(int q)             { return m_storage.Ff()[q]; }
+        inline value_type **Ff()                 { return m_storage.Ff(); }
+        inline const value_type *X(int i) const  { return m_storage.X()[i * (multirate_nodes - 1)]; }
+        inline value_type *X(int i)              { return m_storage.X()[i * (multirate_nodes - 1)]; }
+        inline const value_type *Xf(int q) const { return m_storage.X()[q]; }
+        inline value_type *Xf(int q)             { return m_storage.X()[q]; }
+        inline void update()                     { m_storage.update(); }
+        inline void integrate(value_type Dt)     { m_integrator.integrate(Fs(), Ff(), Dt); }
+        inline value_type dt(int i)              { return m_integrator.dt(i); }
+        inline value_type *workspace(int i)      { return m_integrator.workspace(i); }
+        inline value_type &Immk(int i, int j)    { return m_integrator.Immk[i][j]; }
+        inline value_type &Iqq(int q, int j)     { return m_integrator.Iqq[q][j]; }
+        inline size_t ode_size()                 { return m_storage.ode_size; }
+
+        /**
+         * \brief The right hand sides at the first node are carried over from the end of the last
+         *  step.  Call reset() when the state was changed outside so they are evaluated again.
+         **/
+        inline void reset() { m_initialized = false; }
+
+        /**
+         * \brief The fine substeps use the fine integrals Iqq, fdiff only carries the slow correction.
+         **/
+        inline void add_integral(size_t, value_type *, value_type) {}
+
+        template<typename function_type>
+        inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            m_storage.setX0(x);
+            if(!m_initialized)
+            {
+                F.Explicit(t, x, Fs(0));
+                F.Implicit(t, x, Ff(0));
+                m_initialized = true;
+            }
+            this->predictor(F, t, dt);
+            this->corrector(F, t, dt);
+            update();
+            std::transform(Fs(0), Fs(0) + m_storage.ode_size, Ff(0), v, std::plus<value_type>());
+        }
+
+        /**
+         * \brief Forward Euler substeps over the sdc interval k.  The slow function is frozen at
+         *  the left node and evaluated once at the right node.
+         *
+         * \param t Local substep time
+         * \param dt Local substep timestep
+         **/
+        template<typename function_type>
+        inline void predictor_step(function_type &F, const int k, value_type &t, const value_type &dt)
+        {
+            assert(k < sdc_nodes);
+            value_type *f = workspace(1);
+            value_type tau = t;
+            for(int p = 0, q = k * (multirate_nodes - 1); p < multirate_nodes - 1; ++p, ++q)
+            {
+                value_type dtau = dt * m_integrator.fine_dt(p);
+                std::transform(Fs(k), Fs(k) + m_storage.ode_size, Ff(q), f, std::plus<value_type>());
+                m_euler_solver(Xf(q + 1), Xf(q), f, dtau);
+                tau += dtau;
+                F.Implicit(tau, Xf(q + 1), Ff(q + 1));
+            }
+            t += dt;
+            F.Explicit(t, X(k + 1), Fs(k + 1));
+        }
+
+        /**
+         * \brief Correction substeps over the sdc interval k,
+         *
+         *  x_{q+1} = x_q + dtau*(Fs_new(k) - Fs_old(k) + Ff_new(q) - Ff_old(q)) + Iqq(q)
+         *
+         * \param fdiff Holds Fs_new(k) - Fs_old(k) on entry and Fs_new(k+1) - Fs_old(k+1) on exit.
+         * \param t Local time
+         * \param dt Local timestep
+         **/
+        template<typename function_type>
+        inline void corrector_predictor_step(function_type &F, const int k, value_type *fdiff, value_type &t, const value_type &dt)
+        {
+            assert(k < sdc_nodes);
+            size_t ode_size = m_storage.ode_size;
+            value_type *Fold = workspace(1);
+            value_type *fast_diff = workspace(3);
+            if(k == 0)
+                std::fill(fast_diff, fast_diff + ode_size, value_type(0));
+
+            value_type tau = t;
+            for(int p = 0, q = k * (multirate_nodes - 1); p < multirate_nodes - 1; ++p, ++q)
+            {
+                value_type dtau = dt * m_integrator.fine_dt(p);
+                const value_type *x0 = Xf(q), *I = &Iqq(q, 0);
+                value_type *x1 = Xf(q + 1);
+                for(size_t j = 0; j < ode_size; ++j)
+                    x1[j] = x0[j] + dtau * (fdiff[j] + fast_diff[j]) + I[j];
+                tau += dtau;
+                std::copy(Ff(q + 1), Ff(q + 1) + ode_size, Fold);
+                F.Implicit(tau, x1, Ff(q + 1));
+                std::transform(Ff(q + 1), Ff(q + 1) + ode_size, Fold, fast_diff, std::minus<value_type>());
+            }
+
+            t += dt;
+            std::copy(Fs(k + 1), Fs(k + 1) + ode_size, Fold);
+            F.Explicit(t, X(k + 1), Fs(k + 1));
+            std::transform(Fs(k + 1), Fs(k + 1) + ode_size, Fold, fdiff, std::minus<value_type>());
+        }
+
+};
+
+template<typename _value_type, typename _spectral_integrator_type, int _sdc_corrections>
+struct sdc_traits<MultirateSDC<_value_type, _spectral_integrator_type, _sdc_corrections> >
+{
+    typedef _value_type value_type;
+    enum
+    {
+        sdc_nodes = _spectral_integrator_type::sdc_nodes,
+        sdc_corrections = _sdc_corrections
+    };
+};
+
+#endif
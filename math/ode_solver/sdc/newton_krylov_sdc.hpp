@@ -21,12 +21,17 @@
 #include "math/ode_solver/sdc/integrator/clenshaw_curtis.hpp"
 #include "math/ode_solver/sdc/explicit_sdc.hpp"
 #include "math/nonlinear_solver/inexact_newton.hpp"
+#include "math/nonlinear_solver/anderson_acceleration.hpp"
 
-template < typename value_type, typename ode_rhs_type, int gmres_iterations = 1000, int gmres_restarts = 100, int sdc_nodes = 5, int num_corrections = 5 >
+/**
+ * \brief Solves for the fixed point of the SDC sweep, x = X_end(x).  The nonlinear solver is chosen at
+ *  compile time, e.g. InexactNewtonMethod or AndersonAcceleration.
+ **/
+template < typename value_type, typename ode_rhs_type, int gmres_iterations = 1000, int gmres_restarts = 100, int sdc_nodes = 5, int num_corrections = 5,
+           typename nonlinear_solver_type = InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts> >
 class NewtonKrylovSdc
 {
     protected:
-        typedef InexactNewtonMethod<value_type, gmres_iterations, gmres_restarts> newton_solver_type;
         class nonlinear_operator
         {
         protected:
@@ -64,15 +69,15 @@ class NewtonKrylovSdc
 
     public:
         nonlinear_operator m_F;
-        newton_solver_type m_newton_solver;
+        nonlinear_solver_type m_nonlinear_solver;
 
     public:
-        NewtonKrylovSdc(ode_rhs_type &F) : m_F(F), m_newton_solver(F.ode_size()) {}
+        NewtonKrylovSdc(ode_rhs_type &F) : m_F(F), m_nonlinear_solver(F.ode_size()) {}
 
         inline void operator()(value_type t, value_type *x, value_type *v, value_type dt)
         {
             m_F.init(t, dt, v);
-            m_newton_solver(m_F, x, 1e-12, 1e-6);
+            m_nonlinear_solver(m_F, x, 1e-12, 1e-6);
         }
 
 };
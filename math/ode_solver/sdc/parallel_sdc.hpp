@@ -0,0 +1,274 @@
+#ifndef PARALLEL_SDC_HPP
+#define PARALLEL_SDC_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/sdc/sweep_preconditioner.hpp"
+
+/**
+ * \brief Diagonal sweep preconditioners Q_D = diag(d_m) of ParallelSDC.
+ *
+ *  PICARD is d_m = 0, the sweep is fully explicit.  IMPLICIT_EULER is d_m = tau_m, an implicit
+ *  Euler step from the start of the step to every node.  MIN_SR_NS is d_m = tau_m/M, M being the
+ *  number of nodes after the first one, it minimizes the spectral radius of the iteration in the
+ *  non-stiff limit and diverges for stiff problems.  MIN_SR_FLEX uses d_m = tau_m/k in the sweep
+ *  k = 1..M, in the stiff limit the product of these M sweeps is zero.  It restarts at k = 1 every
+ *  M sweeps and is the default.  The MIN_SR diagonals are the ones of MinSRNSSweep and
+ *  MinSRFlexSweep.
+ **/
+enum diagonal_preconditioner { PICARD, IMPLICIT_EULER, MIN_SR_NS, MIN_SR_FLEX };
+
+/**
+ * \brief Parallel across the nodes SDC.
+ *
+ *  The sweeps use a diagonal preconditioner, every node is updated from the values of the
+ *  previous sweep only,
+ *
+ *      X_m - Dt*d_m*Fi(X_m) = X_0 + int_{t_0}^{t_m} (Fi + Fe) - Dt*d_m*Fi_m^old,
+ *
+ *  so the sdc_nodes-1 implicit solves and right hand side evaluations of a sweep are independent
+ *  and run concurrently, one OpenMP thread (team with nested parallelism) per node.  F.Implicit and
+ *  F.Explicit have to be safe to call concurrently, otherwise call setNodeParallel(false).  Each
+ *  node owns its implicit solver.
+ *
+ *  A diagonal sweep gains less than a Gauss-Seidel like sweep of SemiImplicitSDC, the payoff is
+ *  the concurrency.  The predictor is parallel across the nodes as well.
+ *
+ * \param spectral_integrator_type The integrator method used in the correction step.
+ * \param sdc_corrections Number of corrections to do.
+ **/
+template < typename value_type, typename spectral_integrator_type = Integrator<value_type, gauss_lobatto>, int sdc_corrections = 8 >
+class ParallelSDC : public SDCBase<ParallelSDC<value_type, spectral_integrator_type, sdc_corrections> >
+{
+    protected:
+        typedef BackwardEuler<value_type> backward_euler_type;
+        enum
+        {
+            sdc_nodes = spectral_integrator_type::sdc_nodes
+        };
+
+    protected:
+        internal::sdc_storage < value_type,
+        sdc_nodes, internal::SEMI_IMPLICIT >                    m_storage;
+        spectral_integrator_type                                m_integrator;
+        std::vector<backward_euler_type*>                       m_solvers;
+        std::vector<value_type>                                 m_rhs[sdc_nodes - 1];
+        diagonal_preconditioner                                 m_preconditioner;
+        bool                                                    m_parallel;
+        bool                                                    m_initialized;
+
+    public:
+        ParallelSDC(size_t ode_size) : m_storage(ode_size), m_solvers(sdc_nodes - 1), m_parallel(true), m_initialized(false)
+        {
+            m_integrator.init(ode_size);
+            for(int m = 0; m < sdc_nodes - 1; ++m)
+            {
+                m_solvers[m] = new backward_euler_type(ode_size);
+                m_rhs[m].resize(ode_size);
+            }
+            setPreconditioner(MIN_SR_FLEX);
+        }
+
+        ~ParallelSDC()
+        {
+            for(int m = 0; m < sdc_nodes - 1; ++m)
+                delete m_solvers[m];
+        }
+
+        inline const value_type* Fi(int i) const { return m_storage.Fi()[i]; }
+        inline value_type* Fi(int i)             { return m_storage.Fi()[i]; }
+        inline value_type** Fi()                 { return m_storage.Fi(); }
+        inline const value_type* Fe(int i) const { return m_storage.Fe()[i]; }
+        inline value_type* Fe(int i)             { return m_storage.Fe()[i]; }
+        inline value_type** Fe()                 { return m_storage.Fe(); }
+        inline const value_type* X(int i) const  { return m_storage.X()[i]; }
+        inline value_type* X(int i)              { return m_storage.X()[i]; }
+        inline void update()                     { m_storage.update(); }
+        inline void integrate(value_type Dt)     { m_integrator.integrate(m_storage.Fi(), m_storage.Fe(), Dt); }
+        inline value_type dt(int i)              { return m_integrator.dt(i); }
+        inline value_type *workspace(int i)      { return m_integrator.workspace(i); }
+        inline value_type &Immk(int i, int j)    { return m_integrator.Immk[i][j]; }
+        inline size_t ode_size()                 { return m_storage.ode_size; }
+        inline backward_euler_type &implicit_solver(int m) { return *m_solvers[m - 1]; }
+
+        /**
+         * \brief Run the node updates of a sweep serially, for right hand sides that are not reentrant.
+         **/
+        inline void setNodeParallel(bool parallel) { m_parallel = parallel; }
+
+        inline void setPreconditioner(diagonal_preconditioner type) { m_preconditioner = type; }
+
+        /**
+         * \brief Diagonal entry d_m of the preconditioner in the sweep i, counting from zero.
+         **/
+        inline value_type diagonal(int m, size_t i)
+        {
+            switch(m_preconditioner)
+            {
+                case PICARD:
+                    return value_type(0);
+                case IMPLICIT_EULER:
+                    return m_integrator.node(m);
+                case MIN_SR_NS:
+                    return sweep_diagonal<MinSRNSSweep>(m, i);
+                default:
+                    return sweep_diagonal<MinSRFlexSweep>(m, i);
+            }
+        }
+
+        /**
+         * \brief See SemiImplicitSDC::reset().
+         **/
+        inline void reset() { m_initialized = false; }
+
+        template<typename function_type>
+        inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            m_storage.setX0(x);
+            if(!m_initialized)
+            {
+                F.Implicit(t, x, Fi(0));
+                F.Explicit(t, x, Fe(0));
+                m_initialized = true;
+            }
+            predictor(F, t, dt);
+            this->corrector(F, t, dt);
+            update();
+            std::transform(Fe(0), Fe(0) + m_storage.ode_size, Fi(0), v, std::plus<value_type>());
+        }
+
+        /**
+         * \brief Predictor, a step from the start of the step to every node at once,
+         *
+         *      X_m - Dt*tau_m*Fi(X_m) = X_0 + Dt*tau_m*Fe(X_0),
+         *
+         *  or a forward Euler step with the PICARD preconditioner.
+         **/
+        template<typename function_type>
+        void predictor(function_type &F, value_type t, value_type Dt)
+        {
+            this->request_accuracy(F, this->coarsest_accuracy());
+            size_t N = m_storage.ode_size;
+            bool is_explicit = m_preconditioner == PICARD;
+            for(int m = 1; m < sdc_nodes; ++m)
+            {
+                value_type *rhs = &m_rhs[m - 1][0];
+                value_type c = Dt * m_integrator.node(m);
+                for(size_t j = 0; j < N; ++j)
+                    rhs[j] = X(0)[j] + c * (is_explicit ? Fe(0)[j] + Fi(0)[j] : Fe(0)[j]);
+                std::copy(X(0), X(0) + N, X(m));
+            }
+
+            int m;
+            #pragma omp parallel for schedule(static,1) if(m_parallel)
+            for(m = 1; m < sdc_nodes; ++m)
+                node_update(F, m, t + Dt * m_integrator.node(m), is_explicit ? value_type(0) : Dt * m_integrator.node(m));
+
+            for(int k = 0; k < sdc_nodes - 1; ++k)
+                this->check_convergence(0, k);
+        }
+
+        /**
+         * \brief Diagonally preconditioned sweep, replaces SDCBase::sweep().
+         **/
+        template<typename function_type>
+        void sweep(function_type &F, value_type t, value_type Dt, size_t i)
+        {
+            size_t N = m_storage.ode_size;
+            std::copy(X(sdc_nodes - 1), X(sdc_nodes - 1) + N, workspace(2));
+            integrate(Dt);
+
+            /// Every node reads the values of the previous sweep, so the right hand sides come first
+            value_type *integral = workspace(1);
+            value_type d[sdc_nodes];
+            std::copy(X(0), X(0) + N, integral);
+            for(int m = 1; m < sdc_nodes; ++m)
+            {
+                value_type *rhs = &m_rhs[m - 1][0];
+                const value_type *I = &Immk(m - 1, 0), *fi = Fi(m);
+                d[m] = diagonal(m, i);
+                value_type c = Dt * d[m];
+                for(size_t j = 0; j < N; ++j)
+                {
+                    integral[j] += I[j];
+                    rhs[j] = integral[j] - c * fi[j];
+                }
+            }
+
+            int m;
+            #pragma omp parallel for schedule(static,1) if(m_parallel)
+            for(m = 1; m < sdc_nodes; ++m)
+                node_update(F, m, t + Dt * m_integrator.node(m), Dt * d[m]);
+
+            for(int k = 0; k < sdc_nodes - 1; ++k)
+                this->check_convergence(i + 1, k);
+        }
+
+    private:
+        /**
+         * \brief Diagonal entry m of the start-to-node Q_D of a sweep preconditioner policy.
+         **/
+        template<typename sweep_type>
+        inline value_type sweep_diagonal(int m, size_t i)
+        {
+            const int M = sdc_nodes - 1;
+            value_type tau[sdc_nodes], QD[M * M];
+            for(int k = 0; k < sdc_nodes; ++k)
+                tau[k] = m_integrator.node(k);
+            sweep_type::matrix(tau, (const value_type*)0, M, i, QD);
+            return QD[(m - 1) * M + m - 1];
+        }
+
+        /**
+         * \brief Solves X_m - dt*Fi(X_m) = rhs_m and evaluates the right hand sides at X_m.
+         **/
+        template<typename function_type>
+        inline void node_update(function_type &F, int m, value_type t, value_type dt)
+        {
+            size_t N = m_storage.ode_size;
+            value_type *rhs = &m_rhs[m - 1][0];
+            if(dt == value_type(0))
+            {
+                std::copy(rhs, rhs + N, X(m));
+                F.Implicit(t, X(m), Fi(m));
+            }
+            else
+            {
+                implicit_function<function_type> G(F);
+                (*m_solvers[m - 1])(G, t, X(m), rhs, Fi(m), dt);
+            }
+            F.Explicit(t, X(m), Fe(m));
+        }
+};
+
+template<typename _value_type, typename _integrator_type, int _sdc_corrections>
+struct sdc_traits<ParallelSDC<_value_type, _integrator_type, _sdc_corrections> >
+{
+    typedef _value_type value_type;
+    typedef _integrator_type integrator_type;
+    enum
+    {
+        sdc_nodes = _integrator_type::sdc_nodes,
+        sdc_corrections = _sdc_corrections
+    };
+};
+
+#endif
@@ -19,9 +19,16 @@
 ****************************************************************************/
 
 #include<numeric>
+#include<algorithm>
+#include<cmath>
 #include<cassert>
 #include<stdexcept>
+#include<map>
+#include<string>
+#include<sstream>
+#include<vector>
 
+#include "utils/meta.hpp"
 
 template<typename T> struct sdc_traits;
 
@@ -50,6 +57,19 @@ template<typename T> struct sdc_traits;
  * \endcode
  * The Derived type should define the following two methods used in this class:
  * predictor_step(), corrector_step()
+ *
+ * By default every step takes sdc_corrections-1 correction sweeps.  With setTolerance() the
+ * sweeps stop as soon as the largest node residual, |X(k+1) - X(k) - Immk(k)|, falls below the
+ * tolerance.  setStatistics() collects the sweeps taken ("sdc_sweeps") and the final residual
+ * ("sdc_residual") of every step.
+ *
+ * With setAdaptiveAccuracy() the right hand side is told how accurate the next evaluations need
+ * to be, see requestAccuracy().  Early sweeps only improve the iterate to the size of the current
+ * residual, so a fluid solver can use a cheaper expansion order or kernel precision for them.
+ *
+ * A node residual above 5, or not finite, means the sweeps diverged.  By default check_convergence()
+ * then throws std::out_of_range, with setThrowOnDivergence(false) it sets diverged() and the step
+ * takes no more sweeps, so a step size controller can reject it.
  **/
 template<typename Derived>
 class SDCBase
@@ -72,8 +92,106 @@ class SDCBase
         };
 
         value_type m_residuals[sdc_corrections][sdc_nodes - 1];
+        value_type m_tolerance;
+        size_t m_sweeps;
+        std::map<std::string, std::vector<value_type> > *m_stats;
+        value_type **m_fas;
+        value_type m_accuracy_safety;
+        value_type m_coarsest_accuracy;
+        value_type m_finest_accuracy;
+        int m_stage;
+        size_t m_position;      //< Next predictor substep or correction sweep
+        value_type m_step_t;
+        value_type m_step_dt;
+        value_type m_node_time;
+        bool m_throw_on_divergence;
+        bool m_diverged;
 
     public:
+        /**
+         * \brief Stages of a step taken with begin_step() and resume().
+         **/
+        enum StepStage
+        {
+            step_idle,
+            step_predictor,
+            step_corrector
+        };
+
+        SDCBase() : m_tolerance(0), m_sweeps(0), m_stats(0), m_fas(0), m_accuracy_safety(0), m_coarsest_accuracy(0), m_finest_accuracy(0),
+                    m_stage(step_idle), m_position(0), m_step_t(0), m_step_dt(0), m_node_time(0),
+                    m_throw_on_divergence(true), m_diverged(false) {}
+
+        /**
+         * \brief Residual tolerance for the correction sweeps, 0 (default) always takes sdc_corrections-1 sweeps.
+         **/
+        inline void setTolerance(value_type tol) { m_tolerance = tol; }
+        inline void setStatistics(std::map<std::string, std::vector<value_type> > *stats) { m_stats = stats; }
+
+        /**
+         * \brief FAS corrections of a coarse level, tau[k] is added to the integral between the
+         *  nodes k and k+1 in the sweeps.  Pass 0 (default) to sweep without them.
+         **/
+        inline void setFAS(value_type **tau) { m_fas = tau; }
+
+        /**
+         * \brief Request accuracies from the right hand side during the step.  The predictor asks
+         *  for coarsest, the sweep i for safety times the residual of the sweep before it, clamped
+         *  to [finest,coarsest], and the last sweep for finest.  After the step the accuracy is back
+         *  to finest.  finest has to be below the sweep tolerance for the sweeps to reach it.  A
+         *  safety of 0 (default) disables the requests.  Only right hand sides with a
+         *  setAccuracy(tol) method are affected, the requests are recorded in "sdc_accuracy".
+         **/
+        inline void setAdaptiveAccuracy(value_type safety, value_type coarsest, value_type finest)
+        {
+            m_accuracy_safety = safety;
+            m_coarsest_accuracy = coarsest;
+            m_finest_accuracy = finest;
+        }
+
+        /**
+         * \brief Accuracy requested by the predictor, see setAdaptiveAccuracy().
+         **/
+        inline value_type coarsest_accuracy() const { return m_coarsest_accuracy; }
+
+        /**
+         * \brief Throw std::out_of_range (default) when the sweeps diverge or only flag the step, see diverged().
+         **/
+        inline void setThrowOnDivergence(bool enable) { m_throw_on_divergence = enable; }
+
+        /**
+         * \brief True if a node residual of the last step was above the divergence bound or not finite.
+         **/
+        inline bool diverged() const { return m_diverged; }
+
+        /**
+         * \brief Number of correction sweeps taken in the last step.
+         **/
+        inline size_t sweeps() const { return m_sweeps; }
+
+        /**
+         * \brief Largest node residual of the last sweep.
+         **/
+        inline value_type residual() const { return residual(m_sweeps); }
+
+        /**
+         * \brief Solution at the last node before the last correction sweep.  Its difference with
+         *  the final solution estimates the error of the step.  Only valid if sweeps() > 0.
+         **/
+        inline const value_type *previous_sweep() { return sdc_method().workspace(2); }
+
+        /**
+         * \brief Order of the error estimate given by previous_sweep().
+         **/
+        inline int estimate_order() const { return int(m_sweeps); }
+
+        inline value_type residual(size_t sweep) const
+        {
+            value_type r = value_type(0);
+            for(size_t k = 0; k < sdc_nodes - 1; ++k)
+                r = std::max(r, m_residuals[sweep][k]);
+            return r;
+        }
 
         /**
          * @brief This function returns an instance of the sdc_method (child) type.
@@ -96,12 +214,9 @@ class SDCBase
 //             assert ( sdc_method().X() != 0 && sdc_method().F() != 0 && "sdc_base::corrector(): You can not use this method with uninitialized arguments." );
             value_type time = t;
 
+            request_accuracy(F, m_coarsest_accuracy);
             for(size_t k = 0; k < sdc_nodes - 1; ++k)
-            {
-                value_type dt = Dt * sdc_method().dt(k);
-                sdc_method().predictor_step(F, k, time, dt);
-                check_convergence(0, k);
-            }
+                predictor_substep(F, k, time, Dt);
         }
 
         /**
@@ -113,54 +228,212 @@ class SDCBase
         inline void corrector(function_type &F, value_type t, value_type Dt)
         {
 //             assert ( sdc_method().X() != 0 && sdc_method().F() != 0 && "sdc_base::corrector(): You can not use this method with uninitialized arguments." );
-            size_t ode_size = sdc_method().ode_size();
-            std::vector<value_type> fdiff(ode_size, 0.0);
-
+            m_sweeps = 0;
             for(size_t i = 0; i < sdc_corrections - 1; ++i)
+                if(!correction_sweep(F, t, Dt, i))
+                    break;
+            finish_corrector(F);
+        }
+
+        /**
+         * \brief Start a step that is taken piecewise by resume(), see the begin() method of the
+         *  SDC variants.  The state passed to begin() is only updated when the step is done, so
+         *  between the calls to resume() it still holds the solution at the start of the step.
+         **/
+        template<typename function_type>
+        inline void begin_step(function_type &F, value_type t, value_type Dt)
+        {
+            m_step_t = t;
+            m_step_dt = Dt;
+            m_node_time = t;
+            m_position = 0;
+            m_sweeps = 0;
+            m_stage = step_predictor;
+            request_accuracy(F, m_coarsest_accuracy);
+        }
+
+        /**
+         * \brief Take the next predictor substep or correction sweep of the step started by begin().
+         *  The last call finishes the step, like operator() would, and returns false.
+         *
+         * \return true while the step is not done.
+         **/
+        template<typename function_type>
+        bool resume(function_type &F)
+        {
+            switch(m_stage)
             {
-                sdc_method().integrate(Dt);
-                value_type time = t;
-                for(size_t k = 0; k < sdc_nodes - 1; ++k)
-                {
-                    value_type dt = Dt * sdc_method().dt(k);
-                    for(size_t j = 0; j < ode_size; ++j)
-                        fdiff[j] += sdc_method().Immk(k, j) / dt;
-                    sdc_method().corrector_predictor_step(F, k, &fdiff[0], time, dt);
-                    check_convergence(i + 1, k);
-                }
-//                 if(m_residuals[i][sdc_nodes - 2] < 1e-13)
-//                 {
-//                     sdc_method().update();
-//                     return;
-//                 }
-                std::fill(fdiff.begin(), fdiff.end(), value_type(0));
+                case step_predictor:
+                    predictor_substep(F, m_position, m_node_time, m_step_dt);
+                    if(++m_position < sdc_nodes - 1)
+                        return true;
+                    m_position = 0;
+                    m_stage = step_corrector;
+                    if(sdc_corrections > 1)
+                        return true;
+                    break;
+                case step_corrector:
+                    if(correction_sweep(F, m_step_t, m_step_dt, m_position) && ++m_position < sdc_corrections - 1)
+                        return true;
+                    break;
+                default:
+                    return false;
             }
-            for ( size_t i = 0; i < sdc_corrections; ++i )
+            finish_corrector(F);
+            m_stage = step_idle;
+            sdc_method().end_step();
+            return false;
+        }
+
+        /**
+         * \brief Abandon the step started by begin().  The state was not touched, the step can be
+         *  started again, e.g. with a smaller step size.  With adaptive accuracy F keeps the last
+         *  accuracy requested until the next step.
+         **/
+        inline void cancel() { m_stage = step_idle; }
+
+        inline StepStage stage() const { return StepStage(m_stage); }
+
+        /**
+         * \brief Predictor substeps or correction sweeps taken in the current stage.
+         **/
+        inline size_t position() const { return m_position; }
+
+        /**
+        * \brief One correction sweep over all the nodes.  Multilevel methods drive the sweeps of
+        *  every level with it and methods with a different sweep (see ParallelSDC) hide it.
+        *
+        * \param t Global time
+        * \param i Index of the sweep in the step, sweeps() is i+1 afterwards.
+        **/
+        template<typename function_type>
+        inline void sweep(function_type &F, value_type t, value_type Dt, size_t i)
+        {
+            assert(i < sdc_corrections - 1);
+            size_t ode_size = sdc_method().ode_size();
+            value_type *fdiff = sdc_method().workspace(0);
+            std::fill(fdiff, fdiff + ode_size, value_type(0));
+            const value_type *x_end = sdc_method().X(sdc_nodes - 1);
+            std::copy(x_end, x_end + ode_size, sdc_method().workspace(2));
+            sdc_method().integrate(Dt);
+            value_type time = t;
+            for(size_t k = 0; k < sdc_nodes - 1; ++k)
             {
-                for ( size_t k = 0; k < sdc_nodes - 1; ++k )
-                    std::cout << m_residuals[i][k] << " ";
-                std::cout << std::endl;
+                value_type dt = Dt * sdc_method().dt(k);
+                sdc_method().add_integral(k, fdiff, dt);
+                sdc_method().corrector_predictor_step(F, k, fdiff, time, dt);
+                check_convergence(i + 1, k);
             }
-            std::cout << "+++++++++++++++++++++++++++++++++++++++++++++++++++++++" << std::endl;
+            m_sweeps = i + 1;
+        }
+
+        /**
+         * \brief Predictor substep from the node k, time is advanced to the node k+1.
+         **/
+        template<typename function_type>
+        inline void predictor_substep(function_type &F, size_t k, value_type &time, value_type Dt)
+        {
+            value_type dt = Dt * sdc_method().dt(k);
+            sdc_method().predictor_step(F, k, time, dt);
+            check_convergence(0, k);
+        }
+
+        /**
+         * \brief Correction sweep i with its accuracy request.
+         *
+         * \return false when the residual is below the tolerance or the step diverged and no more
+         *  sweeps are needed.
+         **/
+        template<typename function_type>
+        inline bool correction_sweep(function_type &F, value_type t, value_type Dt, size_t i)
+        {
+            if(m_diverged)
+                return false;
+            if(i + 2 < sdc_corrections)
+                request_accuracy(F, m_accuracy_safety * residual(i));
+            else
+                request_accuracy(F, m_finest_accuracy);
+            sdc_method().sweep(F, t, Dt, i);
+            m_sweeps = i + 1;
+            return !m_diverged && !(m_tolerance > 0 && residual(m_sweeps) < m_tolerance);
+        }
+
+        template<typename function_type>
+        inline void finish_corrector(function_type &F)
+        {
+            request_accuracy(F, m_finest_accuracy);
+            if(m_stats)
+            {
+                std::map<std::string, std::vector<value_type> > &s = *m_stats;
+                s["sdc_sweeps"].push_back(m_sweeps);
+                s["sdc_residual"].push_back(residual());
+            }
+        }
+
+        /**
+         * \brief Adds the integral between the nodes k and k+1, divided by dt, to the correction
+         *  term of the substep.  Methods that take their own substeps inside the node interval
+         *  (see MultirateSDC) hide it.
+         **/
+        inline void add_integral(size_t k, value_type *fdiff, value_type dt)
+        {
+            size_t ode_size = sdc_method().ode_size();
+            for(size_t j = 0; j < ode_size; ++j)
+                fdiff[j] += sdc_method().Immk(k, j) / dt;
+            if(m_fas)
+                for(size_t j = 0; j < ode_size; ++j)
+                    fdiff[j] += m_fas[k][j] / dt;
+        }
+
+        /**
+         * \brief Passes tol, clamped to the accuracy range, to F if adaptive accuracy is enabled.
+         **/
+        template<typename function_type>
+        inline void request_accuracy(function_type &F, value_type tol)
+        {
+            if(m_accuracy_safety <= 0)
+                return;
+            tol = std::max(m_finest_accuracy, std::min(m_coarsest_accuracy, tol));
+            requestAccuracy(F, tol);
+            if(m_stats)
+                (*m_stats)["sdc_accuracy"].push_back(tol);
         }
 
         void check_convergence(int i, int k)
         {
             size_t ode_size = sdc_method().ode_size();
-            std::vector<value_type> tmp(ode_size, 0.0);
-            std::transform(sdc_method().X(k), sdc_method().X(k) + ode_size, &sdc_method().Immk(k, 0), tmp.begin(), std::plus<value_type>());
-            std::transform(sdc_method().X(k + 1), sdc_method().X(k + 1) + ode_size, tmp.begin(), tmp.begin(), std::minus<value_type>());
-            m_residuals[i][k] = std::sqrt(std::inner_product(tmp.begin(), tmp.end(), tmp.begin(), 0.0));
-            if(m_residuals[i][k] > 5)
+            const value_type *x0 = sdc_method().X(k), *x1 = sdc_method().X(k + 1), *I = &sdc_method().Immk(k, 0);
+            value_type sum = value_type(0);
+            if(m_fas)
+                for(size_t j = 0; j < ode_size; ++j)
+                {
+                    value_type r = x1[j] - (x0[j] + I[j] + m_fas[k][j]);
+                    sum += r * r;
+                }
+            else
+                for(size_t j = 0; j < ode_size; ++j)
+                {
+                    value_type r = x1[j] - (x0[j] + I[j]);
+                    sum += r * r;
+                }
+            m_residuals[i][k] = std::sqrt(sum);
+            /// A step starts with the predictor, or with the first sweep on levels without one (see
+            /// MultilevelSDC).  A diverged predictor takes no sweeps, so its flag is kept.
+            if(k == 0 && i <= 1)
+                m_diverged = false;
+            if(!(m_residuals[i][k] <= 5))
+                m_diverged = true;
+            if(m_diverged && m_throw_on_divergence)
             {
-                std::cout << "correction = " << i << ", iteration = " << k << std::endl;
+                std::ostringstream message;
+                message << "sdc residual is out of bound: SDC_BASE::CHECK_CONVERGENCE, correction = " << i << ", iteration = " << k << ", residuals:";
                 for(int j = 0; j <= i; ++j)
                 {
+                    message << "\n";
                     for(int l = 0; l <= k; ++l)
-                        std::cout << m_residuals[j][l] << " ";
-                    std::cout << std::endl;
+                        message << " " << m_residuals[j][l];
                 }
-                throw std::out_of_range("sdc residual is out of bound: SDC_BASE::CHECK_CONVERGENCE");
+                throw std::out_of_range(message.str());
             }
         }
 
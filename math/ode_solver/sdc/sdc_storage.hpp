@@ -154,28 +154,61 @@ namespace internal
     };
 
 
+    /** \internal
+     *
+     * \brief Multirate storage.  X and the fast right hand side live on the total_nodes fine nodes,
+     *  the slow right hand side only on the sdc nodes.  The sdc node m is the fine node
+     *  m*(multirate_nodes-1).
+     */
+    template<typename T, int sdc_nodes, int multirate_nodes>
+    class sdc_storage<T, sdc_nodes, MULTIRATE, multirate_nodes>
+    {
+        public:
+            enum { total_nodes = (sdc_nodes - 1) * (multirate_nodes - 1) + 1 };
+        private:
+            sdc_arrays<T*, total_nodes, total_nodes + sdc_nodes> m_data;
+        public:
+            size_t ode_size;
+            inline explicit sdc_storage(size_t _ode_size) : ode_size(_ode_size)
+            {
+                for(int i = 1; i < total_nodes; ++i)
+                    m_data.X[i] = new T[ode_size];
+                for(int i = 0; i < total_nodes + sdc_nodes; ++i)
+                    m_data.F[i] = new T[ode_size];
+            }
+
+            ~sdc_storage()
+            {
+                for(int i = 1; i < total_nodes; ++i)
+                    delete [] m_data.X[i];
+                for(int i = 0; i < total_nodes + sdc_nodes; ++i)
+                    delete [] m_data.F[i];
+            }
+
+            inline void swap(sdc_storage &other) { std::swap(m_data, other.m_data); }
+
+            inline void update()
+            {
+                std::copy(m_data.F[total_nodes - 1], m_data.F[total_nodes - 1] + ode_size, m_data.F[0]);
+                std::copy(m_data.F[total_nodes + sdc_nodes - 1], m_data.F[total_nodes + sdc_nodes - 1] + ode_size, m_data.F[total_nodes]);
+                std::copy(m_data.X[total_nodes - 1], m_data.X[total_nodes - 1] + ode_size, m_data.X[0]);
+            }
+
+            inline void setX0(T *x)
+            {
+                m_data.X[0] = x;
+            }
+
+            inline const T **Ff() const { return m_data.F; }
+            inline T **Ff() { return m_data.F; }
+            inline const T **Fs() const { return &m_data.F[total_nodes]; }
+            inline T **Fs() { return &m_data.F[total_nodes]; }
+            inline const T **X() const { return m_data.X; }
+            inline T **X() { return m_data.X; }
+    };
+
 } // internal
 
-// template<typename T, int sdc_nodes, int multirate_nodes>
-// class sdc_storage<T,sdc_nodes,multirate_nodes,SDC::MULTIRATE>
-// {
-//         sdc_arrays<T*,sdc_nodes, ( sdc_nodes-1 ) * ( multirate_nodes-1 ) + 1> m_data;
-//     public:
-//         inline explicit sdc_storage() {}
-//
-//         inline void swap ( sdc_storage& other ) { std::swap ( m_data,other.m_data ); }
-//
-//         inline void update() { m_data.F[0] = m_data.F[sdc_nodes-1]; m_data.X[0] = m_data.X[sdc_nodes-1]; }
-//
-//         inline const T *F() const { return m_data.F; }
-//
-//         inline T *F() { return m_data.F; }
-//
-//         inline const T *X() const { return m_data.X; }
-//
-//         inline T *X() { return m_data.X; }
-// };
-//
 // template<typename T, int sdc_nodes, int multirate_nodes>
 // class sdc_storage<T,sdc_nodes,multirate_nodes,SDC::SEMI_IMPLICIT_MULTIRATE>
 // {
@@ -23,6 +23,8 @@
 #include "math/ode_solver/euler/backward_euler.hpp"
 #include "math/ode_solver/euler/forward_euler.hpp"
 #include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/sweep_preconditioner.hpp"
+#include "math/ode_solver/sdc/dense_output.hpp"
 
 template<typename function_type>
 struct implicit_function
@@ -43,13 +45,22 @@ struct implicit_function
  * \param explicit_function_type The right hand side function of the differential equation.
  * \param integrator_type The integrator method used in the correction step.
  * \param sdc_corrections Number of corrections to do.
+ * \param sweep_preconditioner_type Lower triangular preconditioner of the implicit part in the
+ *  sweeps, see sweep_preconditioner.hpp.  The default is backward Euler from node to node, LUSweep
+ *  needs far fewer sweeps, and so implicit solves, for stiff problems.
  **/
-template < typename value_type, typename spectral_integrator_type = Integrator<value_type, gauss_lobatto>, int sdc_corrections = 8 >
-class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_integrator_type, sdc_corrections> >
+template < typename value_type, typename spectral_integrator_type = Integrator<value_type, gauss_lobatto>, int sdc_corrections = 8, typename sweep_preconditioner_type = ImplicitEulerSweep >
+class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_integrator_type, sdc_corrections, sweep_preconditioner_type> >
 {
     protected:
         typedef BackwardEuler<value_type> backward_euler_type;
         typedef ForwardEuler     forward_euler_type;
+        typedef SDCBase<SemiImplicitSDC<value_type, spectral_integrator_type, sdc_corrections, sweep_preconditioner_type> > base_type;
+        enum
+        {
+            sdc_nodes = spectral_integrator_type::sdc_nodes,
+            M = sdc_nodes - 1
+        };
 
     protected:
         internal::sdc_storage < value_type,
@@ -58,12 +69,30 @@ class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_inte
         spectral_integrator_type                                m_integrator;
         backward_euler_type                                     m_backward_euler;
         forward_euler_type                                      m_forward_euler;
+        bool                                                    m_initialized;
+        value_type                                              m_tau[sdc_nodes];
+        value_type                                              m_Q[M * M];         //< Collocation matrix of the nodes after the first one
+        value_type                                              m_sweep_matrix[M * M];  //< Q_D in node to node form
+        std::vector<value_type>                                 m_dFi[M];           //< Change of Fi at every node in the sweep
+        value_type                                              m_Dt;
+        DenseOutput<value_type, spectral_integrator_type>       m_dense_output;
+        value_type                                              *m_v;               //< Velocity of the step taken by resume()
 
     public:
-        SemiImplicitSDC(size_t ode_size) : m_storage(ode_size), m_backward_euler(ode_size), m_forward_euler(ode_size)
+        SemiImplicitSDC(size_t ode_size) : m_storage(ode_size), m_backward_euler(ode_size), m_forward_euler(ode_size), m_initialized(false), m_Dt(0), m_v(0)
         {
             m_integrator.init(ode_size);
-
+            for(int j = 0; j < sdc_nodes; ++j)
+                m_tau[j] = m_integrator.node(j);
+            for(int m = 0; m < M; ++m)
+                for(int j = 0; j < M; ++j)
+                    m_Q[m * M + j] = (m > 0 ? m_Q[(m - 1) * M + j] : value_type(0)) + m_integrator.matrix(m, j + 1);
+            if(!is_default_sweep((sweep_preconditioner_type*)0))
+            {
+                for(int m = 0; m < M; ++m)
+                    m_dFi[m].resize(ode_size);
+                compute_sweep_matrix(0);
+            }
         }
 
         inline const value_type* Fi(int i) const { return m_storage.Fi()[i]; }
@@ -81,18 +110,92 @@ class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_inte
         inline void update()                         { m_storage.update(); }
         inline void integrate(value_type Dt)                      { m_integrator.integrate(m_storage.Fi(), m_storage.Fe(), Dt); }
         inline value_type dt(int i)              { return m_integrator.dt(i); }
+        inline value_type *workspace(int i)      { return m_integrator.workspace(i); }
         inline value_type &Immk(int i, int j) { return m_integrator.Immk[i][j]; }
         inline const value_type &Immk(int i, int j) const { return m_integrator.Immk[i][j]; }
         inline size_t ode_size() { return m_storage.ode_size; }
+        inline backward_euler_type &implicit_solver() { return m_backward_euler; }
+
+        /**
+         * \brief Bytes held by the state, right hand side and scratch vectors, see LowStorageSDC::storage().
+         *  The implicit solver and the dense output are not counted.
+         **/
+        inline size_t storage() const
+        {
+            /// m_storage holds the nodes after the first one and the implicit and explicit right hand sides
+            size_t size = (sdc_nodes - 1 + 2 * sdc_nodes) * m_storage.ode_size;
+            for(int m = 0; m < M; ++m)
+                size += m_integrator.Immk[m].size() + m_dFi[m].size();
+            for(int i = 0; i < spectral_integrator_type::workspace_size; ++i)
+                size += m_integrator.m_workspace[i].size();
+            return size * sizeof(value_type);
+        }
+
+        /**
+         * \brief The right hand sides at the first node are carried over from the end of the last
+         *  step.  Call reset() when the state was changed outside (e.g. a rejected step was rolled
+         *  back) so they are evaluated again.
+         **/
+        inline void reset() { m_initialized = false; }
+
+        /**
+         * \brief Linearly implicit substeps, see BackwardEuler::setLinearlyImplicit().  The Jacobian of
+         *  F.Implicit is frozen at the start of every step, the sweeps correct the linearization error
+         *  so they converge to the same collocation solution.
+         **/
+        inline void setLinearlyImplicit(bool linear, value_type tol = 1e-10) { m_backward_euler.setLinearlyImplicit(linear, tol); }
+
+        /**
+         * \brief See ExplicitSDC::setDenseOutput().
+         **/
+        inline void setDenseOutput(bool enable) { m_dense_output.enable(m_storage.ode_size, enable); }
+
+        /**
+         * \brief Solution at any time t inside the last step, interpolating Fi + Fe.
+         **/
+        inline void dense_output(value_type t, value_type *x) { m_dense_output(t, x, Fi(), Fe()); }
+        inline const DenseOutput<value_type, spectral_integrator_type> &dense_output() const { return m_dense_output; }
 
         template<typename function_type>
         inline void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
         {
+            begin(F, t, x, v, dt);
+            while(this->resume(F))
+                ;
+        }
+
+        /**
+         * \brief See ExplicitSDC::begin().
+         **/
+        template<typename function_type>
+        inline void begin(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            m_v = v;
             m_storage.setX0(x);
-            predictor(F, t, dt);
-            corrector(F, t, dt);
+            if(!m_initialized)
+            {
+                F.Implicit(t, x, Fi(0));
+                F.Explicit(t, x, Fe(0));
+                /// The predictor starts its implicit solves from the nodes of the last step, on the
+                /// first step there are none yet
+                for(int k = 1; k < sdc_nodes; ++k)
+                    std::copy(x, x + m_storage.ode_size, X(k));
+                m_initialized = true;
+            }
+            if(m_backward_euler.linearlyImplicit())
+            {
+                implicit_function<function_type> G(F);
+                m_backward_euler.linearize(G, t, x);
+            }
+            if(m_dense_output.enabled())
+                m_dense_output.start(t, dt, x, Fi(0), Fe(0));
+            this->begin_step(F, t, dt);
+        }
+
+        inline void end_step()
+        {
             update();
-            std::transform(Fe(0), Fe(0) + m_storage.ode_size, Fi(0), v, std::plus<value_type>());
+            std::transform(Fe(0), Fe(0) + m_storage.ode_size, Fi(0), m_v, std::plus<value_type>());
         }
 
         /**
@@ -114,9 +217,12 @@ class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_inte
             assert(k < spectral_integrator_type::sdc_nodes);
             implicit_function<function_type> G(F);
             t += dt;
-            std::vector<value_type> buffer(m_storage.ode_size);
-            m_forward_euler(&buffer[0], X(k), Fe(k), dt);
-            m_backward_euler(G, t, X(k + 1), &buffer[0], Fi(k + 1), dt);
+            value_type *buffer = workspace(1);
+            m_forward_euler(buffer, X(k), Fe(k), dt);
+            /// A single linear solve depends on its initial guess, start from the last node
+            if(m_backward_euler.linearlyImplicit())
+                std::copy(X(k), X(k) + m_storage.ode_size, X(k + 1));
+            m_backward_euler(G, t, X(k + 1), buffer, Fi(k + 1), dt);
             F.Explicit(t, X(k + 1), Fe(k + 1));
         }
 
@@ -135,27 +241,112 @@ class SemiImplicitSDC : public SDCBase<SemiImplicitSDC<value_type, spectral_inte
          **/
         template<typename function_type>
         inline void corrector_predictor_step(function_type &F, const int k, value_type *fdiff, value_type &t, const value_type &dt)
+        {
+            corrector_predictor_step(F, k, fdiff, t, dt, (sweep_preconditioner_type*)0);
+        }
+
+        /**
+         * \brief Records the step size and the sweep index for the preconditioner, then calls SDCBase::sweep().
+         **/
+        template<typename function_type>
+        inline void sweep(function_type &F, value_type t, value_type Dt, size_t i)
+        {
+            m_Dt = Dt;
+            if(sweep_preconditioner_type::sweep_dependent)
+                compute_sweep_matrix(i);
+            base_type::sweep(F, t, Dt, i);
+        }
+
+        /**
+         * \brief Entry (m,j) of the preconditioner in node to node form, the step from node m to node m+1
+         *  uses row m.
+         **/
+        inline value_type sweep_matrix(int m, int j) const { return m_sweep_matrix[m * M + j]; }
+
+    private:
+        static inline bool is_default_sweep(ImplicitEulerSweep*) { return true; }
+        template<typename T>
+        static inline bool is_default_sweep(T*) { return false; }
+
+        void compute_sweep_matrix(size_t i)
+        {
+            value_type QD[M * M];
+            sweep_preconditioner_type::matrix(m_tau, m_Q, M, i, QD);
+            for(int m = 0; m < M; ++m)
+                for(int j = 0; j < M; ++j)
+                    m_sweep_matrix[m * M + j] = m > 0 ? QD[m * M + j] - QD[(m - 1) * M + j] : QD[j];
+        }
+
+        /**
+         * \brief Node to node backward Euler substep.
+         **/
+        template<typename function_type>
+        inline void corrector_predictor_step(function_type &F, const int k, value_type *fdiff, value_type &t, const value_type &dt, ImplicitEulerSweep*)
         {
             assert(k < spectral_integrator_type::sdc_nodes);
             implicit_function<function_type> G(F);
-            std::vector<value_type> buffer(m_storage.ode_size);
-	    
+            value_type *buffer = workspace(1);
+
             t += dt;
             std::transform(fdiff, fdiff + m_storage.ode_size, Fi(k + 1), fdiff, std::minus<value_type>());
-            m_forward_euler(&buffer[0], X(k), fdiff, dt);
-            m_backward_euler(G, t, X(k + 1), &buffer[0], Fi(k + 1), dt);
-	    
-            std::copy(Fe(k + 1), Fe(k + 1) + m_storage.ode_size, buffer.begin());
+            m_forward_euler(buffer, X(k), fdiff, dt);
+            m_backward_euler(G, t, X(k + 1), buffer, Fi(k + 1), dt);
+
+            std::copy(Fe(k + 1), Fe(k + 1) + m_storage.ode_size, buffer);
             F.Explicit(t, X(k + 1), Fe(k + 1));
-            std::transform(Fe(k + 1), Fe(k + 1) + m_storage.ode_size, buffer.begin(), fdiff, std::minus<value_type>());
+            std::transform(Fe(k + 1), Fe(k + 1) + m_storage.ode_size, buffer, fdiff, std::minus<value_type>());
         }
 
+        /**
+         * \brief Substep with a general lower triangular preconditioner.  It solves
+         *
+         *      X_{k+1} - Dt*d*Fi(X_{k+1}) = X_k + dt*fdiff - Dt*d*Fi_{k+1} + Dt*sum_{l<k} D[k][l]*dFi_l,
+         *
+         *  D being Q_D in node to node form, d = D[k][k] and dFi_l the change of Fi at the node l+1
+         *  in this sweep.
+         **/
+        template<typename function_type, typename preconditioner_type>
+        inline void corrector_predictor_step(function_type &F, const int k, value_type *fdiff, value_type &t, const value_type &dt, preconditioner_type*)
+        {
+            assert(k < spectral_integrator_type::sdc_nodes);
+            size_t N = m_storage.ode_size;
+            value_type *buffer = workspace(1), *dFi = &m_dFi[k][0];
+            value_type d = m_Dt * sweep_matrix(k, k);
 
+            t += dt;
+            std::copy(Fi(k + 1), Fi(k + 1) + N, dFi);
+            for(size_t j = 0; j < N; ++j)
+                buffer[j] = X(k)[j] + dt * fdiff[j] - d * dFi[j];
+            for(int l = 0; l < k; ++l)
+            {
+                value_type c = m_Dt * sweep_matrix(k, l);
+                if(c == value_type(0))
+                    continue;
+                const value_type *dF = &m_dFi[l][0];
+                for(size_t j = 0; j < N; ++j)
+                    buffer[j] += c * dF[j];
+            }
+            if(d == value_type(0))
+            {
+                std::copy(buffer, buffer + N, X(k + 1));
+                F.Implicit(t, X(k + 1), Fi(k + 1));
+            }
+            else
+            {
+                implicit_function<function_type> G(F);
+                m_backward_euler(G, t, X(k + 1), buffer, Fi(k + 1), d);
+            }
+            for(size_t j = 0; j < N; ++j)
+                dFi[j] = Fi(k + 1)[j] - dFi[j];
 
+            std::copy(Fe(k + 1), Fe(k + 1) + N, buffer);
+            F.Explicit(t, X(k + 1), Fe(k + 1));
+            std::transform(Fe(k + 1), Fe(k + 1) + N, buffer, fdiff, std::minus<value_type>());
+        }
 };
 
-template<typename _value_type, typename _integrator_type, int _sdc_corrections>
-struct sdc_traits<SemiImplicitSDC<_value_type, _integrator_type, _sdc_corrections> >
+template<typename _value_type, typename _integrator_type, int _sdc_corrections, typename _sweep_preconditioner_type>
+struct sdc_traits<SemiImplicitSDC<_value_type, _integrator_type, _sdc_corrections, _sweep_preconditioner_type> >
 {
     typedef _value_type value_type;
     typedef _integrator_type integrator_type;
@@ -0,0 +1,226 @@
+#ifndef STIFFNESS_SWITCHING_SDC_HPP
+#define STIFFNESS_SWITCHING_SDC_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<vector>
+#include<map>
+#include<string>
+#include<algorithm>
+
+#include "math/nonlinear_solver/newton_base.hpp"
+#include "math/ode_solver/sdc/sdc_base.hpp"
+
+/**
+ * \brief Right hand side F(t,x,v) at a fixed time, as the operator F(x,v) of directional_derivative.
+ **/
+template<typename value_type, typename function_type>
+struct fixed_time_function
+{
+    function_type &m_F;
+    value_type m_t;
+    size_t m_ode_size;
+    fixed_time_function(function_type &F, value_type t, size_t ode_size) : m_F(F), m_t(t), m_ode_size(ode_size) {}
+
+    inline void operator()(const value_type *x, value_type *Fx)
+    {
+        std::fill(Fx, Fx + m_ode_size, value_type(0));
+        m_F(m_t, const_cast<value_type*>(x), Fx);
+    }
+};
+
+/**
+ * \brief Switches between an explicit and a semi-implicit SDC method as the stiffness changes.
+ *
+ *  Every check_interval steps the spectral radius rho of the Jacobian of F is estimated by a power
+ *  iteration on the finite difference directional derivative, warm started from the last estimate.
+ *  The implicit method takes over when rho*dt exceeds the stability limit of the explicit one, and
+ *  the explicit method comes back when rho*dt falls below hysteresis times the limit.  The default
+ *  limit, sdc_nodes - 1, is below the real axis stability limit of explicit SDC, about 1.3 per
+ *  substep, because the power iteration underestimates rho.
+ *
+ *  The state is carried over, only the right hand sides at the start of the step are evaluated again.
+ *  A check costs power_iterations + 1 evaluations of F.  F needs operator() for the explicit method
+ *  and Explicit/Implicit for the semi-implicit one.  setStatistics() collects the estimates of rho*dt
+ *  ("stiffness") and the method used after every check ("stiff", 1 for the implicit one).
+ *
+ * \param explicit_sdc_type E.g. ExplicitSDC.
+ * \param implicit_sdc_type E.g. SemiImplicitSDC.
+ **/
+template<typename value_type, typename explicit_sdc_type, typename implicit_sdc_type>
+class StiffnessSwitchingSDC
+{
+    protected:
+        enum
+        {
+            sdc_nodes = sdc_traits<explicit_sdc_type>::sdc_nodes
+        };
+
+    protected:
+        size_t                  m_ode_size;
+        explicit_sdc_type       m_explicit;
+        implicit_sdc_type       m_implicit;
+        bool                    m_stiff;
+        size_t                  m_steps;
+        size_t                  m_check_interval;
+        int                     m_power_iterations;
+        value_type              m_stability_limit;
+        value_type              m_hysteresis;
+        value_type              m_spectral_radius;
+        std::vector<value_type> m_w;            //< Estimate of the dominant eigenvector
+        std::vector<value_type> m_Jw;
+        std::vector<value_type> m_f0;
+        std::map<std::string, std::vector<value_type> > *m_stats;
+
+    public:
+        StiffnessSwitchingSDC(size_t ode_size) :
+                m_ode_size(ode_size),
+                m_explicit(ode_size),
+                m_implicit(ode_size),
+                m_stiff(false),
+                m_steps(0),
+                m_check_interval(10),
+                m_power_iterations(10),
+                m_stability_limit(sdc_nodes - 1),
+                m_hysteresis(.5),
+                m_spectral_radius(0),
+                m_w(ode_size),
+                m_Jw(ode_size),
+                m_f0(ode_size),
+                m_stats(0)
+        {
+            /// Start vector with components in every direction
+            for(size_t i = 0; i < ode_size; ++i)
+                m_w[i] = std::cos(value_type(7 * i + 1));
+        }
+
+        inline explicit_sdc_type &explicit_method() { return m_explicit; }
+        inline implicit_sdc_type &implicit_method() { return m_implicit; }
+        inline bool stiff() const { return m_stiff; }
+        inline value_type spectral_radius() const { return m_spectral_radius; }
+        inline void setStatistics(std::map<std::string, std::vector<value_type> > *stats) { m_stats = stats; }
+
+        /**
+         * \brief Steps between stiffness checks, 1 checks every step.
+         **/
+        inline void setCheckInterval(size_t steps) { m_check_interval = std::max(steps, size_t(1)); }
+        inline void setPowerIterations(int iterations) { m_power_iterations = iterations; }
+
+        /**
+         * \brief Largest rho*dt for the explicit method, it is used again below hysteresis*limit.
+         **/
+        inline void setStabilityLimit(value_type limit, value_type hysteresis = .5)
+        {
+            m_stability_limit = limit;
+            m_hysteresis = hysteresis;
+        }
+
+        /**
+         * \brief See SemiImplicitSDC::reset().  The stiffness is checked again on the next step.
+         **/
+        inline void reset()
+        {
+            m_explicit.reset();
+            m_implicit.reset();
+            m_steps = 0;
+        }
+
+        /**
+         * \brief Error estimate of the method that took the last step, see Surface::run().
+         **/
+        inline const value_type *previous_sweep() { return m_stiff ? m_implicit.previous_sweep() : m_explicit.previous_sweep(); }
+        inline int estimate_order() const { return m_stiff ? m_implicit.estimate_order() : m_explicit.estimate_order(); }
+
+        /**
+         * \brief See SDCBase::setThrowOnDivergence(), it applies to both methods.
+         **/
+        inline void setThrowOnDivergence(bool enable)
+        {
+            m_explicit.setThrowOnDivergence(enable);
+            m_implicit.setThrowOnDivergence(enable);
+        }
+        inline bool diverged() const { return m_stiff ? m_implicit.diverged() : m_explicit.diverged(); }
+
+        template<typename function_type>
+        void operator()(function_type &F, value_type t, value_type *x, value_type *v, value_type dt)
+        {
+            if(m_steps++ % m_check_interval == 0)
+            {
+                bool stiff = m_stiff;
+                value_type stiffness = estimate_spectral_radius(F, t, x) * dt;
+                if(!m_stiff && stiffness > m_stability_limit)
+                    m_stiff = true;
+                else if(m_stiff && stiffness < m_hysteresis * m_stability_limit)
+                    m_stiff = false;
+                /// The explicit method starts from v, the implicit one evaluates its right hand sides again
+                std::copy(m_f0.begin(), m_f0.end(), v);
+                if(m_stiff && !stiff)
+                    m_implicit.reset();
+                if(m_stats)
+                {
+                    (*m_stats)["stiffness"].push_back(stiffness);
+                    (*m_stats)["stiff"].push_back(m_stiff);
+                }
+            }
+            if(m_stiff)
+                m_implicit(F, t, x, v, dt);
+            else
+                m_explicit(F, t, x, v, dt);
+        }
+
+        /**
+         * \brief Power iteration for the spectral radius of the Jacobian of F at (t,x).  F(t,x) is
+         *  left in m_f0.
+         **/
+        template<typename function_type>
+        value_type estimate_spectral_radius(function_type &F, value_type t, const value_type *x)
+        {
+            typedef fixed_time_function<value_type, function_type> operator_type;
+            operator_type G(F, t, m_ode_size);
+            G(x, &m_f0[0]);
+            directional_derivative<operator_type, value_type> J(G, x, &m_f0[0], m_ode_size);
+
+            normalize(&m_w[0]);
+            m_spectral_radius = 0;
+            for(int k = 0; k < m_power_iterations; ++k)
+            {
+                J(&m_w[0], &m_Jw[0]);
+                value_type norm = normalize(&m_Jw[0]);
+                if(norm == value_type(0))
+                    break;
+                m_spectral_radius = norm;
+                m_w.swap(m_Jw);
+            }
+            return m_spectral_radius;
+        }
+
+    private:
+        inline value_type normalize(value_type *w)
+        {
+            value_type norm = 0;
+            for(size_t i = 0; i < m_ode_size; ++i)
+                norm += w[i] * w[i];
+            norm = std::sqrt(norm);
+            if(norm > value_type(0))
+                for(size_t i = 0; i < m_ode_size; ++i)
+                    w[i] /= norm;
+            return norm;
+        }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef SWEEP_PRECONDITIONER_HPP
+#define SWEEP_PRECONDITIONER_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+/**
+ * \brief Sweep preconditioners of the implicit part of SemiImplicitSDC.
+ *
+ *  A sweep approximates the collocation matrix Q by a lower triangular Q_D.  The policies fill
+ *  Q_D in the start-to-node form, X_m = X_0 + Dt*sum_j Q_D[m][j]*Fi_j + ..., for the M nodes after
+ *  the first one.  The arguments are the nodes tau[0..M] and the M x M block Q of the collocation
+ *  matrix (the integration matrix of the rule summed from the first node) that multiplies the
+ *  right hand sides at those nodes, row major.  sweep is the index
+ *  of the sweep in the step, only used by policies with sweep_dependent = 1.
+ **/
+
+/**
+ * \brief Backward Euler from node to node, Q_D[m][j] = tau_j - tau_{j-1} for j <= m.  The default.
+ **/
+struct ImplicitEulerSweep
+{
+    enum { sweep_dependent = 0 };
+
+    template<typename value_type>
+    static void matrix(const value_type *tau, const value_type *, int M, size_t, value_type *QD)
+    {
+        std::fill(QD, QD + M * M, value_type(0));
+        for(int m = 0; m < M; ++m)
+            for(int j = 0; j <= m; ++j)
+                QD[m * M + j] = tau[j + 1] - tau[j];
+    }
+};
+
+/**
+ * \brief Weiser's LU trick, Q_D = U^T where Q^T = LU with L unit lower triangular.  The iteration
+ *  matrix is nilpotent in the stiff limit.
+ **/
+struct LUSweep
+{
+    enum { sweep_dependent = 0 };
+
+    template<typename value_type>
+    static void matrix(const value_type *, const value_type *Q, int M, size_t, value_type *QD)
+    {
+        /// Doolittle factorization of Q^T in place, no pivoting is needed for the collocation matrices
+        std::vector<long double> A(M * M);
+        for(int i = 0; i < M; ++i)
+            for(int j = 0; j < M; ++j)
+                A[i * M + j] = Q[j * M + i];
+        for(int k = 0; k < M; ++k)
+            for(int i = k + 1; i < M; ++i)
+            {
+                long double l = A[i * M + k] / A[k * M + k];
+                for(int j = k; j < M; ++j)
+                    A[i * M + j] -= l * A[k * M + j];
+            }
+        std::fill(QD, QD + M * M, value_type(0));
+        for(int m = 0; m < M; ++m)
+            for(int j = 0; j <= m; ++j)
+                QD[m * M + j] = value_type(A[j * M + m]);
+    }
+};
+
+/**
+ * \brief Diagonal Q_D[m][m] = tau_m/M, optimal in the non-stiff limit.
+ **/
+struct MinSRNSSweep
+{
+    enum { sweep_dependent = 0 };
+
+    template<typename value_type>
+    static void matrix(const value_type *tau, const value_type *, int M, size_t, value_type *QD)
+    {
+        std::fill(QD, QD + M * M, value_type(0));
+        for(int m = 0; m < M; ++m)
+            QD[m * M + m] = tau[m + 1] / M;
+    }
+};
+
+/**
+ * \brief Diagonal Q_D[m][m] = tau_m/k in the sweep k = 1..M, restarted every M sweeps.  The product
+ *  of M sweeps vanishes in the stiff limit.
+ **/
+struct MinSRFlexSweep
+{
+    enum { sweep_dependent = 1 };
+
+    template<typename value_type>
+    static void matrix(const value_type *tau, const value_type *, int M, size_t sweep, value_type *QD)
+    {
+        std::fill(QD, QD + M * M, value_type(0));
+        for(int m = 0; m < M; ++m)
+            QD[m * M + m] = tau[m + 1] / (sweep % M + 1);
+    }
+};
+
+#endif
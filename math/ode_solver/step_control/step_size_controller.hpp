@@ -0,0 +1,144 @@
+#ifndef STEP_SIZE_CONTROLLER_HPP
+#define STEP_SIZE_CONTROLLER_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<algorithm>
+#include<limits>
+
+/**
+ * \brief Step size controller for adaptive time stepping.
+ *
+ *  The local error is measured as the scaled RMS norm of the difference between the solution
+ *  and an embedded lower order solution (e.g. the previous SDC sweep),
+ *
+ *      err = sqrt(1/n sum_i ((x_i - y_i)/(atol + rtol*|x_i|))^2),
+ *
+ *  and the step is accepted when err <= 1.  The new step is
+ *
+ *      dt_new = dt * safety * err^(-kI/k) * err_old^(kP/k),
+ *
+ *  where k is the order of the error estimate plus one.  With kP = 0 this is the elementary
+ *  controller, the default gains kI = .7, kP = .4 give a PI controller.  After a rejection the
+ *  elementary controller is used.  The factor dt_new/dt and dt_new itself are kept within bounds.
+ **/
+template<typename value_type>
+class StepSizeController
+{
+    private:
+        value_type m_atol;
+        value_type m_rtol;
+        value_type m_safety;
+        value_type m_min_factor;
+        value_type m_max_factor;
+        value_type m_min_step;
+        value_type m_max_step;
+        value_type m_kI;
+        value_type m_kP;
+        value_type m_error_old;
+        bool m_rejected;
+        size_t m_accepted_steps;
+        size_t m_rejected_steps;
+
+    public:
+        StepSizeController(value_type atol = 1e-6, value_type rtol = 1e-6) :
+                m_atol(atol),
+                m_rtol(rtol),
+                m_safety(.9),
+                m_min_factor(.2),
+                m_max_factor(5),
+                m_min_step(0),
+                m_max_step(std::numeric_limits<value_type>::max()),
+                m_kI(.7),
+                m_kP(.4),
+                m_error_old(1),
+                m_rejected(false),
+                m_accepted_steps(0),
+                m_rejected_steps(0)
+        {}
+
+        inline void setTolerances(value_type atol, value_type rtol) { m_atol = atol; m_rtol = rtol; }
+        inline void setStepLimits(value_type min_step, value_type max_step) { m_min_step = min_step; m_max_step = max_step; }
+        inline void setFactorLimits(value_type min_factor, value_type max_factor) { m_min_factor = min_factor; m_max_factor = max_factor; }
+        inline void setSafety(value_type safety) { m_safety = safety; }
+
+        /**
+         * \brief Set the controller gains, kP = 0 gives the elementary controller.
+         **/
+        inline void setGains(value_type kI, value_type kP) { m_kI = kI; m_kP = kP; }
+
+        inline size_t accepted() const { return m_accepted_steps; }
+        inline size_t rejected() const { return m_rejected_steps; }
+        inline void reset() { m_error_old = 1; m_rejected = false; m_accepted_steps = m_rejected_steps = 0; }
+
+        /**
+         * \brief Scaled RMS norm of x - y.
+         *
+         * \param x Solution.
+         * \param y Embedded lower order solution.
+         * \param n Size of the vectors.
+         **/
+        value_type error(const value_type *x, const value_type *y, size_t n) const
+        {
+            value_type sum = value_type(0);
+            for(size_t i = 0; i < n; ++i)
+            {
+                value_type e = (x[i] - y[i]) / (m_atol + m_rtol * std::fabs(x[i]));
+                sum += e * e;
+            }
+            return std::sqrt(sum / n);
+        }
+
+        /**
+         * \brief Accepts or rejects the step and proposes the next step size.
+         *
+         * \param err Scaled error of the step.
+         * \param order Order of the error estimate.
+         * \param dt Step size taken, on return the step size for the next (or repeated) step.
+         * \return true if the step is accepted.
+         **/
+        bool update(value_type err, int order, value_type &dt)
+        {
+            value_type k = value_type(order + 1);
+            err = std::max(err, std::numeric_limits<value_type>::epsilon());
+            bool accepted = err <= value_type(1) || dt <= m_min_step;
+            value_type factor;
+            if(accepted && !m_rejected)
+                factor = m_safety * std::pow(err, -m_kI / k) * std::pow(m_error_old, m_kP / k);
+            else
+                factor = m_safety * std::pow(err, -value_type(1) / k);
+            if(accepted)
+            {
+                /// Do not grow the step right after a rejection
+                factor = std::min(factor, m_rejected ? value_type(1) : m_max_factor);
+                m_error_old = err;
+                ++m_accepted_steps;
+            }
+            else
+            {
+                factor = std::min(factor, value_type(1));
+                ++m_rejected_steps;
+            }
+            m_rejected = !accepted;
+            factor = std::max(factor, m_min_factor);
+            dt = std::min(std::max(dt * factor, m_min_step), m_max_step);
+            return accepted;
+        }
+};
+
+#endif
@@ -17,21 +17,28 @@
 ** You should have received a copy of the GNU General Public License
 ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****************************************************************************/
-
+#include "utils/meta.hpp"
+#include "utils/memoized_function.hpp"
 
 /** \class FluidSolver
  *  \ingroup ParticleSystem_Module
  *  \brief Wrapper for the fluid solver to use
  *  \tparam Derived is the derived type, ie the application type or an expresion
+ *
+ *  With setMemoization() the velocities of the last evaluations are kept and a fluid solve at the
+ *  same time, positions and forces returns them instead, see RhsCache.  The forces are still
+ *  computed, they are part of the key.
  */
 template<typename Derived>
 class FluidSolver
 {
     protected:
         typedef typename Traits<Derived>::fluid_solver_type fluid_solver_type;
+        typedef typename Traits<Derived>::value_type value_type;
 
     private:
         fluid_solver_type m_fluid_solver;
+        RhsCache<value_type> m_cache[3];    //< operator(), Explicit and Implicit
 
     public:
         FluidSolver(size_t num_particles) : m_fluid_solver(num_particles) {}
@@ -41,34 +48,83 @@ class FluidSolver
             return *static_cast<Derived*>(this);
         }
 
-        template<typename value_type>
         inline void operator()(value_type t, value_type *x, value_type *v)
         {
             derived().computeForces(t);
+            if(lookup(0, t, x, v))
+                return;
             m_fluid_solver(t,x,v,derived().forces());
+            store(0, t, x, v);
         }
 
-        template<typename value_type>
         inline void operator()(value_type t, value_type *x, value_type *v, size_t num_targets)
         {
             m_fluid_solver(t,x,v,derived().positions(),derived().forces(),num_targets);
         }
 
-        template<typename value_type>
         inline void Explicit(value_type t, value_type *x, value_type *v)
         {
             derived().computeForces(t);
+            if(lookup(1, t, x, v))
+                return;
             m_fluid_solver.Explicit(t,x,v,derived().forces());
+            store(1, t, x, v);
         }
 
-        template<typename value_type>
         inline void Implicit(value_type t, value_type *x, value_type *v)
         {
             derived().computeForces(t);
+            if(lookup(2, t, x, v))
+                return;
             m_fluid_solver.Implicit(t,x,v,derived().forces());
+            store(2, t, x, v);
+        }
+
+        /**
+         * \brief Accuracy requested by the time integrator for the next evaluations, forwarded
+         *  to fluid solvers that can trade accuracy for speed.
+         **/
+        inline void setAccuracy(value_type tol)
+        {
+            requestAccuracy(m_fluid_solver, tol);
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].setAccuracy(tol);
+        }
+
+        /**
+         * \brief Number of fluid solves kept for reuse, 0 (default) disables the memoization.
+         **/
+        inline void setMemoization(size_t capacity)
+        {
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].setCapacity(capacity);
+        }
+
+        /**
+         * \brief Drop the kept velocities, e.g. after the fluid parameters changed.
+         **/
+        inline void invalidateMemoization()
+        {
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].invalidate();
         }
 
+        inline const RhsCache<value_type> &memoization(int i) const { return m_cache[i]; }
+
         fluid_solver_type &fluid_solver() { return m_fluid_solver; }
+
+    private:
+        inline bool lookup(int i, value_type t, const value_type *x, value_type *v)
+        {
+            size_t size = derived().data_size();
+            return m_cache[i].lookup(t, x, size, v, size, derived().forces(), size);
+        }
+
+        inline void store(int i, value_type t, const value_type *x, const value_type *v)
+        {
+            size_t size = derived().data_size();
+            m_cache[i].store(t, x, size, v, size, derived().forces(), size);
+        }
 };
 
 
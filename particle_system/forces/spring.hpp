@@ -92,13 +92,18 @@ class Spring
             apply(x1, x2, m_A->force, m_B->force);
         }
 
-        inline void apply(const value_type *x1, const value_type *x2, value_type *f1, value_type *f2)
+        /**
+         * Computes the spring forces.  Templated on the scalar type so it can be evaluated on Dual numbers.
+         */
+        template<typename T>
+        inline void apply(const T *x1, const T *x2, T *f1, T *f2)
         {
-            value_type dx[3] = {x1[0] - x2[0], x1[1] - x2[1], x1[2] - x2[2]};
-            value_type l = std::sqrt(dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2]);
+            using std::sqrt;
+            T dx[3] = {x1[0] - x2[0], x1[1] - x2[1], x1[2] - x2[2]};
+            T l = sqrt(dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2]);
             if(l == 0)
                 throw std::domain_error("Spring::apply(): Non-positive spring length");
-            value_type L = m_k * (1.0 - m_l / l);
+            T L = m_k * (1.0 - m_l / l);
             f1[0] -= L * dx[0];
             f1[1] -= L * dx[1];
             f1[2] -= L * dx[2];
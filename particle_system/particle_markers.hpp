@@ -39,6 +39,13 @@ class ParticleMarkers : public ParticleSystem<ParticleMarkers<surface_type, time
     public:
         ParticleMarkers(size_t num_particles) : base_type(num_particles), m_integrator(3*num_particles) {  }
 
+        inline time_integrator &integrator() { return m_integrator; }
+
+        /**
+         * \brief Drop the state the integrator kept from previous steps, call it after placing the markers.
+         **/
+        inline void reset() { m_integrator.reset(); }
+
         template<typename value_type>
         void run(value_type timestep, surface_type &surface)
         {
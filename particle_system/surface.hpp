@@ -17,6 +17,10 @@
 ** You should have received a copy of the GNU General Public License
 ** along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ****************************************************************************/
+#include<vector>
+#include<algorithm>
+#include<limits>
+
 #include "particle_system/elastic_system/elastic_boundary.hpp"
 #include "particle_system/particle_system.hpp"
 #include "particle_system/time_integrator.hpp"
@@ -33,9 +37,12 @@ class Surface : public ParticleSystem<Derived>,
                 public TimeIntegrator<Derived>,
                 public FluidSolver<Derived>
 {
-    
+    private:
+        std::vector<typename Traits<Derived>::value_type> m_saved_state;   //< Positions and velocities at the start of an adaptive step
+        typename Traits<Derived>::value_type m_step_size;                   //< Step size of the step taken by resumeStep()
+
     public:
-        Surface(size_t num_particles) : ParticleSystem<Derived>(num_particles), TimeIntegrator<Derived>(3*num_particles), FluidSolver<Derived>(num_particles) {}
+        Surface(size_t num_particles) : ParticleSystem<Derived>(num_particles), TimeIntegrator<Derived>(3*num_particles), FluidSolver<Derived>(num_particles), m_step_size(0) {}
         ~Surface() {}
 
         inline Derived &derived()
@@ -75,6 +82,78 @@ class Surface : public ParticleSystem<Derived>,
             this->time() += timestep;
         }
 
+        /**
+         * \brief run(timestep) in pieces, so a driver can write output, update a GUI or move
+         *  tracers between them.
+         *
+         *  \code
+            surface.beginStep(timestep);
+            while(surface.resumeStep())
+                render();
+         *  \endcode
+         *
+         *  Every resumeStep() takes one SDC predictor substep or correction sweep.  The positions and
+         *  velocities keep the state at the start of the step until the last call, so a checkpoint
+         *  written between the calls restarts the step.  cancelStep() abandons it, time() and the
+         *  state are unchanged.
+         **/
+        template<typename value_type>
+        inline void beginStep(value_type timestep)
+        {
+            m_step_size = timestep;
+            this->beginIntegration(this->time(),timestep);
+        }
+
+        /**
+         * \return true while the step is not done, after the last piece time() is advanced.
+         **/
+        inline bool resumeStep()
+        {
+            if(this->resumeIntegration())
+                return true;
+            this->time() += m_step_size;
+            return false;
+        }
+
+        inline void cancelStep() { this->cancelIntegration(); }
+
+        /**
+         * \brief Adaptive time step.  The step is repeated from the saved particle state with a
+         *  smaller step size until the controller accepts it.  The error estimate is the difference
+         *  between the last two sweeps, so the time integrator must be an SDC method.
+         *
+         * \param timestep Step size to try.  On return, the step size proposed for the next step.
+         * \param controller Step size controller, see StepSizeController.
+         * \return The step size taken.
+         **/
+        template<typename value_type, typename controller_type>
+        inline value_type run(value_type &timestep, controller_type &controller)
+        {
+            size_t size = this->data_size();
+            value_type *x = this->positions(), *v = this->velocities();
+            m_saved_state.resize(2 * size);
+            std::copy(x, x + size, m_saved_state.begin());
+            std::copy(v, v + size, m_saved_state.begin() + size);
+            this->integrator().setThrowOnDivergence(false);
+            while(true)
+            {
+                value_type dt = timestep;
+                this->integrate(this->time(), dt);
+                /// Diverged sweeps are rejected with the smallest step reduction factor
+                value_type err = std::numeric_limits<value_type>::infinity();
+                if(!this->integrator().diverged())
+                    err = controller.error(x, this->integrator().previous_sweep(), size);
+                if(controller.update(err, this->integrator().estimate_order(), timestep))
+                {
+                    this->time() += dt;
+                    return dt;
+                }
+                std::copy(m_saved_state.begin(), m_saved_state.begin() + size, x);
+                std::copy(m_saved_state.begin() + size, m_saved_state.end(), v);
+                this->integrator().reset();
+            }
+        }
+
         
 };
 
@@ -40,11 +40,28 @@ class TimeIntegrator
             return *static_cast<Derived*>(this);
         }
 
+        inline time_integrator_type &integrator()
+        {
+            return time_integrator;
+        }
+
         template<typename value_type>
         inline void integrate(value_type t, value_type timestep)
         {
             time_integrator(derived(),t,derived().positions(),derived().velocities(),timestep);
         }
+
+        /**
+         * \brief Step taken piecewise, see SDCBase::resume().
+         **/
+        template<typename value_type>
+        inline void beginIntegration(value_type t, value_type timestep)
+        {
+            time_integrator.begin(derived(),t,derived().positions(),derived().velocities(),timestep);
+        }
+
+        inline bool resumeIntegration() { return time_integrator.resume(derived()); }
+        inline void cancelIntegration() { time_integrator.cancel(); }
         
 };
 
@@ -0,0 +1,77 @@
+#include<iostream>
+#include<cmath>
+#include<algorithm>
+
+#include "math/ode_solver/euler/forward_euler.hpp"
+#include "math/ode_solver/multistep/adams_bashforth.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Error at t = 2 of x' = x*cos(t) with n steps.  The step sizes vary by up to 50% when variable is set.
+ **/
+template<int order>
+double error(int n, bool variable)
+{
+    function_type<1> F;
+    AdamsBashforth<double, order> ab(1);
+    double x = 1, v, t = 0;
+    F(t, &x, &v);
+    double total = 0;
+    for(int i = 0; i < n; ++i)
+        total += 1 + (variable ? .5 * std::sin(double(i)) : 0.);
+    for(int i = 0; i < n; ++i)
+    {
+        double dt = 2 * (1 + (variable ? .5 * std::sin(double(i)) : 0.)) / total;
+        ab(F, t, &x, &v, dt);
+        t += dt;
+    }
+    return std::fabs(x - std::exp(std::sin(t)));
+}
+
+template<int order>
+bool check()
+{
+    double rate = std::log(error<order>(100, false) / error<order>(200, false)) / std::log(2.);
+    double variable_rate = std::log(error<order>(100, true) / error<order>(200, true)) / std::log(2.);
+    std::cout << "AB" << order << ": rate = " << rate << ", variable step rate = " << variable_rate << std::endl;
+    return std::fabs(rate - order) < .3 && std::fabs(variable_rate - order) < .3;
+}
+
+int adams_bashforth(int , char **)
+{
+    bool passed = check<2>();
+    passed = check<3>() && passed;
+    passed = check<4>() && passed;
+
+    /// Markers style stepping, the velocity is computed outside and the integrator only moves x
+    function_type<1> F;
+    ForwardEuler euler(1);
+    AdamsBashforth<double, 4> ab(1);
+    double x[2] = {1, 1}, v, t = 0, dt = .01;
+    for(int i = 0; i < 200; ++i, t += dt)
+    {
+        F(t, &x[0], &v);
+        euler(&x[0], &v, dt);
+        F(t, &x[1], &v);
+        ab(&x[1], &v, dt);
+    }
+    double euler_error = std::fabs(x[0] - std::exp(std::sin(t))), ab_error = std::fabs(x[1] - std::exp(std::sin(t)));
+    std::cout << "one velocity per step: forward Euler error = " << euler_error << ", AB4 error = " << ab_error << std::endl;
+    if(ab_error * 10 > euler_error)
+        passed = false;
+
+    /// Markers placed again, see ParticleMarkers::reset(), repeat the first run only if the history is dropped
+    double first_run = x[1];
+    ab.reset();
+    x[1] = 1;
+    t = 0;
+    for(int i = 0; i < 200; ++i, t += dt)
+    {
+        F(t, &x[1], &v);
+        ab(&x[1], &v, dt);
+    }
+    std::cout << "after reset: AB4 difference with the first run = " << std::fabs(x[1] - first_run) << std::endl;
+    if(x[1] != first_run)
+        passed = false;
+    return passed ? 0 : 1;
+}
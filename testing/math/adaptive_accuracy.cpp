@@ -0,0 +1,105 @@
+#include<iostream>
+#include<vector>
+#include<map>
+#include<string>
+#include<cmath>
+#include<cstdlib>
+
+#include "utils/meta.hpp"
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/fluid_solver/stokes/cpu_stokes_solver.hpp"
+
+/**
+ * x' = x*cos(t), evaluated with a relative error equal to the requested accuracy.  The cost of an
+ * evaluation is its number of correct digits, like the expansion order of a multipole method.
+ **/
+struct inexact_function
+{
+    double accuracy;
+    double cost;
+    inexact_function() : accuracy(1e-14), cost(0) {}
+
+    void operator()(double t, const double *x, double *v)
+    {
+        cost += std::max(1.0, std::ceil(-std::log10(accuracy)));
+        v[0] = x[0] * std::cos(t) * (1 + accuracy * std::sin(1e3 * t + x[0]));
+    }
+    void setAccuracy(double tol) { accuracy = tol; }
+    size_t ode_size() { return 1; }
+};
+
+struct exact_function
+{
+    void operator()(double t, const double *x, double *v) { v[0] = x[0] * std::cos(t); }
+};
+
+template<typename sdc_type>
+double solve(sdc_type &sdc, inexact_function &F)
+{
+    double x = 1, v, t = 0, dt = .25;
+    F(t, &x, &v);
+    for(int i = 0; i < 8; ++i, t += dt)
+        sdc(F, t, &x, &v, dt);
+    return std::fabs(x - std::exp(std::sin(t)));
+}
+
+int adaptive_accuracy(int , char **)
+{
+    if(!has_member_setAccuracy<inexact_function>::value || has_member_setAccuracy<exact_function>::value)
+        return 1;
+
+    typedef ExplicitSDC<double, Integrator<double, gauss_lobatto, 5>, 8> sdc_type;
+    inexact_function F_full, F_adaptive;
+    sdc_type full(1), adaptive(1);
+    std::map<std::string, std::vector<double> > stats;
+    adaptive.setAdaptiveAccuracy(.01, 1e-2, 1e-14);
+    adaptive.setStatistics(&stats);
+    double full_error = solve(full, F_full), adaptive_error = solve(adaptive, F_adaptive);
+
+    std::cout << "full accuracy:     error = " << full_error << ", cost = " << F_full.cost << std::endl;
+    std::cout << "adaptive accuracy: error = " << adaptive_error << ", cost = " << F_adaptive.cost << std::endl;
+    std::cout << "requested accuracies of the first step:";
+    for(int i = 0; i < 8; ++i)
+        std::cout << " " << stats["sdc_accuracy"][i];
+    std::cout << std::endl;
+    if(adaptive_error > 2 * full_error + 1e-13 || F_adaptive.cost > .7 * F_full.cost)
+        return 1;
+    if(F_adaptive.accuracy != 1e-14)
+        return 1;
+
+    /// Single precision direct sum for loose accuracies, within the requested relative accuracy
+    srand(0);
+    const size_t num_particles = 200;
+    std::vector<double> x(3 * num_particles), f(3 * num_particles), v(3 * num_particles), v_single(3 * num_particles), v_exact(3 * num_particles);
+    for(size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = rand() / (RAND_MAX + 1.0);
+        f[i] = rand() / (RAND_MAX + 1.0) - .5;
+    }
+    CpuStokesSolver<double> solver(num_particles);
+    solver.setDelta(.05);
+    solver(0, &x[0], &v[0], &f[0]);
+    solver.setAccuracy(1e-4);
+    solver(0, &x[0], &v_single[0], &f[0]);
+    double difference = 0, norm = 0;
+    for(size_t i = 0; i < v.size(); ++i)
+    {
+        difference = std::max(difference, std::fabs(v[i] - v_single[i]));
+        norm = std::max(norm, std::fabs(v[i]));
+    }
+    std::cout << "single precision direct sum: relative difference = " << difference / norm << std::endl;
+    if(difference == 0 || difference > 1e-4 * norm)
+        return 1;
+
+    /// Accuracies below 1e-5, and 0, take the double precision sum again
+    double tolerances[2] = {1e-6, 0};
+    for(int k = 0; k < 2; ++k)
+    {
+        solver.setAccuracy(tolerances[k]);
+        solver(0, &x[0], &v_exact[0], &f[0]);
+        if(v_exact != v)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/ark/additive_runge_kutta.hpp"
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Largest defect of the order conditions up to order four, the ones that couple the two tableaux
+ * included.  The explicit and implicit matrices are indexed by the bits of mask.
+ **/
+template<typename tableau_type>
+double order_defect(const double *b, int order)
+{
+    const int s = tableau_type::stages;
+    const double *A[2] = {tableau_type::explicit_matrix(), tableau_type::implicit_matrix()};
+    const double *c = tableau_type::nodes();
+    double defect = 0;
+    for(int m = 0; m < 2; ++m)
+        for(int i = 0; i < s; ++i)
+        {
+            double sum = 0;
+            for(int j = 0; j < s; ++j)
+                sum += A[m][i * s + j];
+            defect = std::max(defect, std::fabs(sum - c[i]));
+        }
+
+    double q[4] = {0, 0, 0, 0}, exact[4] = {1, 1. / 2, 1. / 3, 1. / 4};
+    for(int i = 0; i < s; ++i)
+        for(int p = 0; p < 4; ++p)
+            q[p] += b[i] * std::pow(c[i], p);
+    for(int p = 0; p < order; ++p)
+        defect = std::max(defect, std::fabs(q[p] - exact[p]));
+
+    for(int mask = 0; mask < 4; ++mask)
+    {
+        const double *X = A[mask & 1], *Y = A[mask >> 1];
+        double bAc = 0, bcAc = 0, bAcc = 0, bAAc = 0;
+        for(int i = 0; i < s; ++i)
+            for(int j = 0; j < s; ++j)
+            {
+                bAc += b[i] * X[i * s + j] * c[j];
+                bcAc += b[i] * c[i] * X[i * s + j] * c[j];
+                bAcc += b[i] * X[i * s + j] * c[j] * c[j];
+                for(int k = 0; k < s; ++k)
+                    bAAc += b[i] * X[i * s + j] * Y[j * s + k] * c[k];
+            }
+        if(order > 2)
+            defect = std::max(defect, std::fabs(bAc - 1. / 6));
+        if(order > 3)
+        {
+            defect = std::max(defect, std::fabs(bcAc - 1. / 8));
+            defect = std::max(defect, std::fabs(bAcc - 1. / 12));
+            defect = std::max(defect, std::fabs(bAAc - 1. / 24));
+        }
+    }
+    return defect;
+}
+
+/**
+ * Prothero-Robinson, x' = lambda*(x - sin(t)) + cos(t), the stiff part is implicit.
+ **/
+struct prothero_robinson
+{
+    double lambda;
+    prothero_robinson(double l) : lambda(l) {}
+    void Explicit(double t, const double *, double *v) { v[0] = std::cos(t); }
+    void Implicit(double t, const double *x, double *v) { v[0] = lambda * (x[0] - std::sin(t)); }
+    void operator()(double t, const double *x, double *v) { v[0] = lambda * (x[0] - std::sin(t)) + std::cos(t); }
+    size_t ode_size() { return 1; }
+};
+
+template<typename tableau_type>
+double prothero_robinson_error(double lambda, int steps)
+{
+    prothero_robinson F(lambda);
+    AdditiveRungeKutta<double, tableau_type> ark(1);
+    double x = 0, v, t = 0, dt = 1. / steps;
+    for(int i = 0; i < steps; ++i, t += dt)
+        ark(F, t, &x, &v, dt);
+    return std::fabs(x - std::sin(1.));
+}
+
+template<typename tableau_type>
+bool check(const char *name)
+{
+    double defect = order_defect<tableau_type>(tableau_type::weights(), tableau_type::order);
+    double embedded_defect = order_defect<tableau_type>(tableau_type::embedded_weights(), tableau_type::embedded_order);
+    double rate = std::log(prothero_robinson_error<tableau_type>(-1, 20) / prothero_robinson_error<tableau_type>(-1, 40)) / std::log(2.);
+    double stiff_error = prothero_robinson_error<tableau_type>(-1e6, 10);
+    std::cout << name << ": order conditions defect = " << defect << ", embedded = " << embedded_defect
+              << ", rate = " << rate << ", stiff error = " << stiff_error << std::endl;
+    /// The explicit tableau is not stiffly accurate, for stiff problems the order reduces but the step stays stable
+    return defect < 1e-12 && embedded_defect < 1e-12 && std::fabs(rate - tableau_type::order) < .3 && stiff_error < 1e-2;
+}
+
+/**
+ * Counts the right hand side evaluations.
+ **/
+template<typename function_type>
+struct counted_function
+{
+    function_type &F;
+    size_t explicit_calls, implicit_calls;
+    counted_function(function_type &f) : F(f), explicit_calls(0), implicit_calls(0) {}
+    void Explicit(double t, const double *x, double *v) { ++explicit_calls; F.Explicit(t, x, v); }
+    void Implicit(double t, const double *x, double *v) { ++implicit_calls; F.Implicit(t, x, v); }
+    void operator()(double t, const double *x, double *v) { F(t, x, v); }
+    size_t ode_size() { return F.ode_size(); }
+};
+
+/**
+ * Integrates the Brusselator up to t = 1 and returns the error against a reference, the number of
+ * right hand side evaluations go to calls.
+ **/
+template<typename method_type, typename function_type>
+double brusselator(function_type &F, const std::vector<double> &reference, int steps, size_t &calls)
+{
+    counted_function<function_type> G(F);
+    std::vector<double> x(F.ode_size()), v(F.ode_size());
+    F.init(0, 1, &x[0]);
+    method_type *method = new method_type(F.ode_size());
+    double dt = 1. / steps;
+    for(int i = 0; i < steps; ++i)
+        (*method)(G, i * dt, &x[0], &v[0], dt);
+    delete method;
+    calls = G.explicit_calls + G.implicit_calls;
+    double error = 0;
+    for(size_t i = 0; i < x.size(); ++i)
+        error = std::max(error, std::fabs(x[i] - reference[i]));
+    return error;
+}
+
+int additive_runge_kutta(int , char **)
+{
+    bool passed = check<ARK324L2SA>("ARK3(2)4L[2]SA");
+    passed = check<ARK436L2SA>("ARK4(3)6L[2]SA") && passed;
+
+    /// Cost against SemiImplicitSDC with 3 nodes and 2 corrections at matched error
+    enum { ode_size = 40 };
+    typedef diffusion_type<double, ode_size> function_type;
+    typedef AdditiveRungeKutta<double, ARK324L2SA> ark3_type;
+    typedef AdditiveRungeKutta<double, ARK436L2SA> ark4_type;
+    typedef SemiImplicitSDC<double, Integrator<double, gauss_lobatto, 3>, 2> sdc_type;
+    function_type F;
+    std::vector<double> reference(ode_size);
+    size_t calls;
+    {
+        std::vector<double> v(ode_size);
+        F.init(0, 1, &reference[0]);
+        ark4_type *method = new ark4_type(ode_size);
+        for(int i = 0; i < 1000; ++i)
+            (*method)(F, i * 1e-3, &reference[0], &v[0], 1e-3);
+        delete method;
+    }
+
+    std::cout << "steps: error (right hand sides) for ARK3, ARK4 and SDC(3,2)" << std::endl;
+    double ark_error[4], sdc_error[4];
+    size_t ark_calls[4], sdc_calls[4];
+    for(int n = 0, steps = 10; n < 4; ++n, steps *= 2)
+    {
+        std::cout << steps << ": ";
+        ark_error[n] = brusselator<ark3_type>(F, reference, steps, ark_calls[n]);
+        std::cout << ark_error[n] << " (" << ark_calls[n] << "), ";
+        double error = brusselator<ark4_type>(F, reference, steps, calls);
+        std::cout << error << " (" << calls << "), ";
+        sdc_error[n] = brusselator<sdc_type>(F, reference, steps, sdc_calls[n]);
+        std::cout << sdc_error[n] << " (" << sdc_calls[n] << ")" << std::endl;
+    }
+
+    /// ARK3 with twice the step size is at least as accurate and cheaper
+    for(int n = 1; n < 4; ++n)
+        if(ark_error[n - 1] > sdc_error[n] || ark_calls[n - 1] >= sdc_calls[n])
+            passed = false;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include<iostream>
+#include<vector>
+#include<map>
+#include<cmath>
+
+#include "math/nonlinear_solver/anderson_acceleration.hpp"
+
+/**
+ * Residual of the fixed point map G(x)_i = 1 + .45*(x_{i-1} + x_{i+1}) + .05*sin(x_i), F(x) = x - G(x).
+ * The plain fixed point iteration contracts at a rate close to .95.
+ **/
+struct fixed_point_residual
+{
+    size_t m_size;
+    fixed_point_residual(size_t size) : m_size(size) {}
+
+    template<typename value_type>
+    void operator()(const value_type *x, value_type *Fx)
+    {
+        for(size_t i = 0; i < m_size; ++i)
+        {
+            value_type left = i > 0 ? x[i - 1] : value_type(0);
+            value_type right = i < m_size - 1 ? x[i + 1] : value_type(0);
+            Fx[i] = x[i] - 1 - .45 * (left + right) - .05 * std::sin(x[i]);
+        }
+    }
+};
+
+int anderson_acceleration(int , char **)
+{
+    typedef double value_type;
+    typedef std::map<std::string, std::vector<value_type> > stats_type;
+
+    const size_t size = 200;
+    const value_type tol = 1e-10;
+    fixed_point_residual F(size);
+
+    stats_type stats;
+    std::vector<value_type> x(size, 0.0), x_picard(size, 0.0), r(size);
+
+    AndersonAcceleration<value_type, 5> anderson(size);
+    int status = anderson(F, &x[0], tol, 0, &stats);
+
+    /// Plain fixed point iteration, x = G(x) = x - F(x)
+    size_t picard_evals = 0;
+    value_type rnorm = 1;
+    while(rnorm > tol && picard_evals < 10000)
+    {
+        F(&x_picard[0], &r[0]);
+        ++picard_evals;
+        rnorm = 0;
+        for(size_t i = 0; i < size; ++i)
+        {
+            rnorm += r[i] * r[i];
+            x_picard[i] -= r[i];
+        }
+        rnorm = std::sqrt(rnorm);
+    }
+
+    value_type difference = 0;
+    for(size_t i = 0; i < size; ++i)
+        difference = std::max(difference, std::fabs(x[i] - x_picard[i]));
+
+    std::cout << "anderson_norm = [";
+    for(size_t i = 0; i < stats["anderson_norm"].size(); ++i)
+        std::cout << stats["anderson_norm"][i] << " ";
+    std::cout << "];" << std::endl;
+    std::cout << "anderson function evaluations = " << stats["anderson_fn_eval"].back() << std::endl;
+    std::cout << "fixed point function evaluations = " << picard_evals << std::endl;
+    std::cout << "difference = " << difference << std::endl;
+
+    return (status == 0 && difference < 1e-8 && stats["anderson_fn_eval"].back() < picard_evals / 3) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include<iostream>
+#include<vector>
+#include<map>
+#include<cmath>
+#include<cstdlib>
+#include<limits>
+#include<numeric>
+
+#include "math/fluid_solver/stokes/cpu_stokes_solver.hpp"
+#include "math/linear_solver/krylov/generalized_minimal_residual_method.hpp"
+#include "math/linear_solver/preconditioner/block_jacobi_preconditioner.hpp"
+
+template<typename value_type>
+struct stokeslet_operator
+{
+    CpuStokesSolver<value_type> &m_solver;
+    const value_type *m_x;
+
+    stokeslet_operator(CpuStokesSolver<value_type> &solver, const value_type *x) : m_solver(solver), m_x(x) {}
+
+    inline void operator()(const value_type *f, value_type *v)
+    {
+        m_solver(0, m_x, v, f);
+    }
+};
+
+/**
+ * Kernel with a zero self interaction block for the particles in [begin,end).
+ **/
+template<typename value_type>
+struct singular_kernel
+{
+    CpuStokesSolver<value_type> &m_solver;
+    const value_type *m_begin, *m_end;
+
+    singular_kernel(CpuStokesSolver<value_type> &solver, const value_type *begin, const value_type *end) : m_solver(solver), m_begin(begin), m_end(end) {}
+
+    inline void block(const value_type *target, const value_type *source, value_type *S)
+    {
+        if(target >= m_begin && target < m_end)
+            std::fill(S, S + 9, value_type(0));
+        else
+            m_solver.block(target, source, S);
+    }
+};
+
+template<typename value_type, typename preconditioner_type>
+size_t solve(stokeslet_operator<value_type> &A, preconditioner_type &M, const std::vector<value_type> &b, std::vector<value_type> &f)
+{
+    typedef std::map<std::string, std::vector<value_type> > stats_type;
+    GeneralizedMinimalResidualMethod<value_type, 50> gmres(b.size());
+    stats_type stats;
+    std::fill(f.begin(), f.end(), value_type(0));
+    value_type bnorm = std::sqrt(std::inner_product(b.begin(), b.end(), b.begin(), value_type(0)));
+    value_type k_err = std::numeric_limits<value_type>::infinity();
+    for(int k_it = 0; k_err > 1e-10 * bnorm && k_it < 20; ++k_it)
+        k_err = gmres(A, M, &b[0], &f[0], 1e-10, &stats);
+    size_t its = 0;
+    for(size_t i = 0; i < stats["gmres_fn_eval"].size(); ++i)
+        its += stats["gmres_fn_eval"][i];
+    return its;
+}
+
+int block_jacobi(int , char **)
+{
+    typedef double value_type;
+
+    srand(0);
+    const size_t num_bodies = 8;
+    const size_t particles_per_body = 24;
+    const size_t num_particles = num_bodies * particles_per_body;
+    const size_t system_size = 3 * num_particles;
+
+    /// Helical towers on a line, similar to a glycocalyx
+    std::vector<value_type> x(system_size);
+    for(size_t b = 0, idx = 0; b < num_bodies; ++b)
+        for(size_t i = 0; i < particles_per_body; ++i, idx += 3)
+        {
+            value_type theta = 2 * M_PI * i / 8;
+            x[idx] = std::cos(theta) + 3.0 * b;
+            x[idx + 1] = std::sin(theta);
+            x[idx + 2] = .25 * i;
+        }
+
+    CpuStokesSolver<value_type> solver(num_particles);
+    solver.setDelta(.25);
+    stokeslet_operator<value_type> A(solver, &x[0]);
+
+    std::vector<value_type> b(system_size), f(system_size), r(system_size);
+    for(size_t i = 0; i < system_size; ++i)
+        b[i] = rand() / (value_type(RAND_MAX) + 1);
+
+    IdentityPreconditioner<value_type> I(system_size);
+    size_t plain_its = solve(A, I, b, f);
+
+    BlockJacobiPreconditioner<value_type> M(system_size);
+    M.setBodies(num_bodies, particles_per_body);
+    size_t factored = M.update(solver, &x[0]);
+    size_t preconditioned_its = solve(A, M, b, f);
+
+    A(&f[0], &r[0]);
+    value_type error = 0, bnorm = 0;
+    for(size_t i = 0; i < system_size; ++i)
+    {
+        error += (r[i] - b[i]) * (r[i] - b[i]);
+        bnorm += b[i] * b[i];
+    }
+    error = std::sqrt(error / bnorm);
+
+    /// A rigid translation keeps the factorizations, deforming one body refactors only that body
+    for(size_t i = 0; i < system_size; i += 3)
+        x[i] += .5;
+    size_t translated = M.update(solver, &x[0]);
+    for(size_t i = 0; i < 3 * particles_per_body; i += 3)
+        x[i] *= 1.1;
+    size_t deformed = M.update(solver, &x[0]);
+
+    /// A singular block is skipped instead of terminating the parallel loop, its body is left
+    /// unpreconditioned and the solve still converges
+    singular_kernel<value_type> K(solver, &x[0], &x[3 * particles_per_body]);
+    BlockJacobiPreconditioner<value_type> S(system_size);
+    S.setBodies(num_bodies, particles_per_body);
+    size_t nonsingular = S.update(K, &x[0]);
+    size_t singular_its = solve(A, S, b, f);
+    A(&f[0], &r[0]);
+    value_type singular_error = 0;
+    for(size_t i = 0; i < system_size; ++i)
+        singular_error += (r[i] - b[i]) * (r[i] - b[i]);
+    singular_error = std::sqrt(singular_error / bnorm);
+
+    std::cout << "gmres iterations = " << plain_its << std::endl;
+    std::cout << "block jacobi gmres iterations = " << preconditioned_its << std::endl;
+    std::cout << "relative residual = " << error << std::endl;
+    std::cout << "refactorizations = [" << factored << " " << translated << " " << deformed << "]" << std::endl;
+    std::cout << "singular block: refactorizations = " << nonsingular << ", gmres iterations = " << singular_its << ", relative residual = " << singular_error << std::endl;
+
+    bool passed = error < 1e-9 && preconditioned_its < plain_its && factored == num_bodies && translated == 0 && deformed == 1;
+    passed = passed && nonsingular == num_bodies - 1 && S.singular(0) && !S.singular(1) && singular_error < 1e-9;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include<iostream>
+#include<cmath>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Largest error of the dense output of x' = x*cos(t) at 20 times inside each of the steps, and
+ * largest difference with the solution at the end of the steps.
+ **/
+template<typename sdc_type>
+double dense_error(double dt, double &end_difference)
+{
+    function_type<1> F;
+    sdc_type sdc(F.ode_size());
+    sdc.setDenseOutput(true);
+    double x = 1, v, t = 0, y;
+    F(t, &x, &v);
+    double error = 0;
+    end_difference = 0;
+    for(int i = 0; i < int(2 / dt + .5); ++i, t += dt)
+    {
+        sdc(F, t, &x, &v, dt);
+        for(int k = 0; k <= 20; ++k)
+        {
+            double s = t + k * dt / 20;
+            sdc.dense_output(s, &y);
+            error = std::max(error, std::fabs(y - std::exp(std::sin(s))));
+        }
+        sdc.dense_output(t + dt, &y);
+        end_difference = std::max(end_difference, std::fabs(y - x));
+    }
+    return error;
+}
+
+template<typename sdc_type>
+bool check(const char *name, int order)
+{
+    double end1, end2;
+    double e1 = dense_error<sdc_type>(.2, end1), e2 = dense_error<sdc_type>(.1, end2);
+    double rate = std::log(e1 / e2) / std::log(2.0);
+    std::cout << name << ": error = " << e1 << ", " << e2 << ", rate = " << rate << ", end difference = " << std::max(end1, end2) << std::endl;
+    return rate > order - .5 && std::max(end1, end2) < 1e-10;
+}
+
+int dense_output(int , char **)
+{
+    typedef double value_type;
+    bool ok = true;
+    /// The interpolant has degree sdc_nodes, or sdc_nodes-1 for Radau, one order less than its error
+    ok = check<ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 12> >("explicit, gauss-lobatto", 6) && ok;
+    ok = check<ExplicitSDC<value_type, Integrator<value_type, clenshaw_curtis, 5>, 12> >("explicit, clenshaw-curtis", 6) && ok;
+    ok = check<ExplicitSDC<value_type, Integrator<value_type, gauss_radau, 5>, 12> >("explicit, gauss-radau", 5) && ok;
+    ok = check<SemiImplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 12> >("semi-implicit, gauss-lobatto", 6) && ok;
+    return ok ? 0 : 1;
+}
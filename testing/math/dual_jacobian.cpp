@@ -0,0 +1,121 @@
+#include<iostream>
+#include<vector>
+#include<map>
+#include<cmath>
+
+#include "particle_system/particle.hpp"
+#include "particle_system/forces/spring.hpp"
+#include "math/fluid_solver/stokes/cpu_stokes_solver.hpp"
+#include "math/ode_solver/euler/backward_euler.hpp"
+#include "math/autodiff/dual_directional_derivative.hpp"
+
+/**
+ * Ring of particles connected by springs and moving in a Stokes fluid, v = S(x)*f(x).
+ **/
+template<typename value_type>
+struct ring_rhs
+{
+    typedef Spring<ParticleWrapper<value_type> > spring_type;
+
+    size_t m_num_particles;
+    CpuStokesSolver<value_type> m_fluid_solver;
+    std::vector<spring_type> m_springs;
+
+    ring_rhs(size_t num_particles) : m_num_particles(num_particles), m_fluid_solver(num_particles), m_springs(num_particles)
+    {
+        m_fluid_solver.setDelta(.1);
+        for(size_t i = 0; i < m_num_particles; ++i)
+        {
+            m_springs[i].stiffness() = 1;
+            m_springs[i].resting_length() = .5 * 2 * M_PI / m_num_particles;
+        }
+    }
+
+    template<typename T>
+    void operator()(T , const T *x, T *v)
+    {
+        std::vector<T> f(3 * m_num_particles, T(0));
+        for(size_t i = 0; i < m_num_particles; ++i)
+        {
+            size_t j = (i + 1) % m_num_particles;
+            m_springs[i].apply(&x[3 * i], &x[3 * j], &f[3 * i], &f[3 * j]);
+        }
+        m_fluid_solver(0, x, v, &f[0]);
+    }
+};
+
+template<typename stats_type>
+double total(stats_type &stats, const std::string &key)
+{
+    double sum = 0;
+    for(size_t i = 0; i < stats[key].size(); ++i)
+        sum += stats[key][i];
+    return sum;
+}
+
+int dual_jacobian(int , char **)
+{
+    typedef double value_type;
+    typedef std::map<std::string, std::vector<value_type> > stats_type;
+    typedef ring_rhs<value_type> function_type;
+    typedef BackwardEulerFunction<value_type, function_type> implicit_function_type;
+
+    const size_t num_particles = 32;
+    const size_t system_size = 3 * num_particles;
+    const value_type dt = .1;
+
+    std::vector<value_type> x0(system_size), w(system_size), f0(system_size);
+    for(size_t i = 0; i < num_particles; ++i)
+    {
+        value_type theta = 2 * M_PI * i / num_particles;
+        x0[3 * i] = std::cos(theta);
+        x0[3 * i + 1] = std::sin(theta);
+        x0[3 * i + 2] = .1 * std::sin(3 * theta);
+        w[3 * i] = std::sin(theta);
+        w[3 * i + 1] = std::cos(2 * theta);
+        w[3 * i + 2] = 1;
+    }
+
+    function_type F(num_particles);
+    implicit_function_type G(F, &x0[0], 0, dt, system_size);
+
+    /// Compare the exact product against central differences
+    G(&x0[0], &f0[0]);
+    dual_directional_derivative<implicit_function_type, value_type> J(G, &x0[0], &f0[0], system_size);
+    std::vector<value_type> Jw(system_size), xp(x0), xm(x0), fp(system_size), fm(system_size);
+    J(&w[0], &Jw[0]);
+    value_type h = 1e-5, error = 0, norm = 0;
+    for(size_t i = 0; i < system_size; ++i)
+    {
+        xp[i] += h * w[i];
+        xm[i] -= h * w[i];
+    }
+    G(&xp[0], &fp[0]);
+    G(&xm[0], &fm[0]);
+    for(size_t i = 0; i < system_size; ++i)
+    {
+        value_type fd = (fp[i] - fm[i]) / (2 * h);
+        error += (fd - Jw[i]) * (fd - Jw[i]);
+        norm += Jw[i] * Jw[i];
+    }
+    error = std::sqrt(error / norm);
+    std::cout << "jvp relative difference = " << error << std::endl;
+
+    /// Solve one implicit step with both Jacobians
+    stats_type fd_stats, dual_stats;
+    std::vector<value_type> x_fd(x0), x_dual(x0);
+    InexactNewtonMethod<value_type, 100, 10> fd_newton(system_size);
+    InexactNewtonMethod<value_type, 100, 10, GeneralizedMinimalResidualMethod<value_type, 100>, dual_directional_derivative> dual_newton(system_size);
+    int fd_status = fd_newton(G, &x_fd[0], 1e-12, 1e-12, &fd_stats);
+    int dual_status = dual_newton(G, &x_dual[0], 1e-12, 1e-12, &dual_stats);
+
+    value_type difference = 0;
+    for(size_t i = 0; i < system_size; ++i)
+        difference = std::max(difference, std::fabs(x_fd[i] - x_dual[i]));
+
+    std::cout << "finite difference gmres iterations = " << total(fd_stats, "gmres_fn_eval") << std::endl;
+    std::cout << "dual gmres iterations = " << total(dual_stats, "gmres_fn_eval") << std::endl;
+    std::cout << "solution difference = " << difference << std::endl;
+
+    return (error < 1e-8 && fd_status == 0 && dual_status == 0 && difference < 1e-10) ? 0 : 1;
+}
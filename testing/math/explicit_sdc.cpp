@@ -5,6 +5,8 @@
 #include <iterator>
 #include<algorithm>
 #include<fstream>
+#include<map>
+#include<vector>
 
 #include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
 #include "math/ode_solver/sdc/explicit_sdc.hpp"
@@ -41,6 +43,36 @@ int explicit_sdc(int , char **)
         std::copy(error,error+size,std::ostream_iterator<value_type>(std::cout," "));
         std::cout << "]\n";
     }
+    {
+        /// Sweeps stop at the residual tolerance
+        function_type<1> F;
+        enum
+        {
+            sdc_nodes = 5,
+            sdc_corrections = 10
+        };
+        typedef Integrator<value_type,gauss_lobatto,sdc_nodes> spectral_integrator;
+        ExplicitSDC<value_type,spectral_integrator,sdc_corrections> fixed_sdc(F.ode_size()), sdc(F.ode_size());
+        std::map<std::string,std::vector<value_type> > stats;
+        sdc.setTolerance(1e-13);
+        sdc.setStatistics(&stats);
+
+        value_type time = 0, dt = .05;
+        value_type x_fixed = 1, f_fixed = 0, x = 1, f = 0;
+        F(time,&x_fixed,&f_fixed);
+        F(time,&x,&f);
+        for (size_t i = 0; i < 20; ++i)
+        {
+            fixed_sdc(F,time,&x_fixed,&f_fixed,dt);
+            sdc(F,time,&x,&f,dt);
+            time += dt;
+        }
+        std::vector<value_type> &sweeps = stats["sdc_sweeps"];
+        value_type total_sweeps = std::accumulate(sweeps.begin(),sweeps.end(),value_type(0));
+        std::cout << "sweeps = " << total_sweeps << " of " << 20*(sdc_corrections-1) << ", difference = " << std::fabs(x - x_fixed) << std::endl;
+        if(sweeps.size() != 20 || total_sweeps >= 20*(sdc_corrections-1) || std::fabs(x - x_fixed) > 1e-12 || stats["sdc_residual"].back() >= 1e-13)
+            return 1;
+    }
     {
         function_type<3> F;
         enum
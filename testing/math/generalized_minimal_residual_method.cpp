@@ -2,6 +2,7 @@
 #include<iterator>
 #include<limits>
 #include<numeric>
+#include<cmath>
 
 #include<vector>
 #include<map>
@@ -98,6 +99,21 @@ struct function_type<20>
     }
 };
 
+/**
+ * Tridiagonal matrix with 4 on the diagonal and -1 off it.
+ **/
+template<typename value_type>
+struct tridiagonal_type
+{
+    size_t m_size;
+    tridiagonal_type(size_t size) : m_size(size) {}
+    void operator() ( const value_type *x, value_type *Fx )
+    {
+        for(size_t i = 0; i < m_size; ++i)
+            Fx[i] = 4*x[i] - (i > 0 ? x[i-1] : value_type(0)) - (i < m_size-1 ? x[i+1] : value_type(0));
+    }
+};
+
 template<typename stats_type>
 void display_stats(stats_type &stats)
 {
@@ -136,5 +152,20 @@ int generalized_minimal_residual_method(int , char **)
 //         gmres ( F,f0,z,1e-16,&stats );
 // 
 //     display_stats(stats);
-    return 0;
+
+    /// An initial guess with a residual larger than the right hand side is replaced by zero,
+    /// so it costs no more iterations than starting from zero
+    const size_t n = 200;
+    tridiagonal_type<value_type> T(n);
+    GeneralizedMinimalResidualMethod<value_type,50> gmres_T(n);
+    std::vector<value_type> x(n, 2.0), b(n), x0(n, 0.0), x1(n, -1e3);
+    T(&x[0], &b[0]);
+    stats_type zero_stats, bad_stats;
+    gmres_T(T, &b[0], &x0[0], 1e-10, &zero_stats);
+    gmres_T(T, &b[0], &x1[0], 1e-10, &bad_stats);
+    value_type e1 = std::sqrt(error_norm(&x1[0], &x[0], n));
+    std::cout << "zero guess: iterations = " << zero_stats["gmres_fn_eval"].back() << std::endl;
+    std::cout << "bad guess: iterations = " << bad_stats["gmres_fn_eval"].back() << ", error = " << e1 << std::endl;
+
+    return (bad_stats["gmres_fn_eval"].back() <= zero_stats["gmres_fn_eval"].back() && e1 < 1e-6) ? 0 : 1;
 }
@@ -2,6 +2,8 @@
 #include<limits>
 #include<cmath>
 #include<map>
+#include<vector>
+#include<iterator>
 #include "math/nonlinear_solver/inexact_newton.hpp"
 
 template<int size>
@@ -37,6 +39,72 @@ void display_stats(stats_type &stats)
     }
 }
 
+/**
+ * Implicit Euler residual of a reaction-diffusion system, G(x) = x - xold - dt*(c*L*x - x^3).
+ * Counts the function evaluations.
+ **/
+template<typename value_type>
+struct implicit_reaction_diffusion
+{
+    size_t m_size;
+    value_type m_dt;
+    const value_type *m_xold;
+    size_t m_evals;
+
+    implicit_reaction_diffusion(size_t size, value_type dt) : m_size(size), m_dt(dt), m_xold(0), m_evals(0) {}
+
+    void operator() ( const value_type *x, value_type *Fx )
+    {
+        ++m_evals;
+        value_type c = 400;
+        for(size_t i = 0; i < m_size; ++i)
+        {
+            value_type left = i > 0 ? x[i-1] : value_type(0);
+            value_type right = i < m_size-1 ? x[i+1] : value_type(0);
+            Fx[i] = x[i] - m_xold[i] - m_dt*(c*(left - 2*x[i] + right) - x[i]*x[i]*x[i]);
+        }
+    }
+};
+
+/**
+ * Takes num_steps implicit steps and returns the total number of function evaluations.
+ **/
+template<typename value_type>
+size_t implicit_steps(bool quasi_newton, std::vector<value_type> &x)
+{
+    const size_t size = x.size();
+    const int num_steps = 20;
+    implicit_reaction_diffusion<value_type> G(size, 1e-3);
+    InexactNewtonMethod<value_type,50,10> newton(size);
+    newton.setQuasiNewton(quasi_newton);
+    std::vector<value_type> xold(size);
+    for(int step = 0; step < num_steps; ++step)
+    {
+        std::copy(x.begin(),x.end(),xold.begin());
+        G.m_xold = &xold[0];
+        if(newton(G,&x[0],1e-8,1e-6) != 0)
+            return std::numeric_limits<size_t>::max();
+    }
+    return G.m_evals;
+}
+
+/**
+ * One stiff implicit step solved to a tight tolerance.  The forcing term has to shrink with the
+ * residual for Newton to converge superlinearly within its iteration limit.
+ **/
+template<typename value_type>
+bool tight_solve()
+{
+    const size_t size = 50;
+    std::vector<value_type> x(size), xold(size);
+    for(size_t i = 0; i < size; ++i)
+        x[i] = xold[i] = 2*std::sin(M_PI*(i+1)/51.0);
+    implicit_reaction_diffusion<value_type> G(size, 1e-2);
+    G.m_xold = &xold[0];
+    InexactNewtonMethod<value_type,50,10> newton(size);
+    return newton(G,&x[0],1e-12,1e-12) == 0;
+}
+
 int inexact_newton(int , char **)
 {
     typedef double value_type;
@@ -51,6 +119,23 @@ int inexact_newton(int , char **)
     newton ( F,x,1e-16f,1e-13f, &stats );
 
     display_stats(stats);
-    return 0;
+
+    /// Sequence of implicit steps with and without quasi-Newton steps
+    std::vector<value_type> x_newton(50), x_quasi(50);
+    for(size_t i = 0; i < x_newton.size(); ++i)
+        x_newton[i] = x_quasi[i] = std::sin(M_PI*(i+1)/51.0);
+    size_t newton_evals = implicit_steps(false, x_newton);
+    size_t quasi_evals = implicit_steps(true, x_quasi);
+    value_type difference = 0;
+    for(size_t i = 0; i < x_newton.size(); ++i)
+        difference = std::max(difference,std::fabs(x_newton[i]-x_quasi[i]));
+    std::cout << "newton-krylov function evaluations = " << newton_evals << std::endl;
+    std::cout << "quasi-newton function evaluations = " << quasi_evals << std::endl;
+    std::cout << "difference = " << difference << std::endl;
+
+    bool converged = tight_solve<value_type>();
+    std::cout << "tight solve converged = " << converged << std::endl;
+
+    return (quasi_evals < newton_evals && difference < 1e-6 && converged) ? 0 : 1;
     
 }
@@ -0,0 +1,76 @@
+#include<iostream>
+#include<iterator>
+#include<vector>
+#include<map>
+#include<cmath>
+#include<cstdlib>
+
+#include "math/fluid_solver/stokes/cpu_stokes_solver.hpp"
+#include "math/linear_solver/refinement/iterative_refinement.hpp"
+
+template<typename value_type>
+struct stokeslet_operator
+{
+    CpuStokesSolver<value_type> m_solver;
+    std::vector<value_type> m_x;
+
+    stokeslet_operator(const std::vector<double> &x, value_type delta) : m_solver(x.size() / 3), m_x(x.begin(), x.end())
+    {
+        m_solver.setDelta(delta);
+    }
+
+    inline void operator()(const value_type *f, value_type *v)
+    {
+        m_solver(0, &m_x[0], v, f);
+    }
+};
+
+int iterative_refinement(int , char **)
+{
+    typedef double value_type;
+    typedef std::map<std::string, std::vector<value_type> > stats_type;
+
+    srand(0);
+    const size_t num_particles = 64;
+    const size_t system_size = 3 * num_particles;
+
+    /// Particles on a helix, similar to a glycocalyx tower
+    std::vector<double> x(system_size);
+    for(size_t i = 0, idx = 0; i < num_particles; ++i, idx += 3)
+    {
+        double theta = 2 * M_PI * i / 8;
+        x[idx] = std::cos(theta);
+        x[idx + 1] = std::sin(theta);
+        x[idx + 2] = .25 * i;
+    }
+
+    stokeslet_operator<double> A(x, .25);
+    stokeslet_operator<float> A_low(x, .25);
+
+    std::vector<value_type> b(system_size), f(system_size, 0.0), r(system_size);
+    for(size_t i = 0; i < system_size; ++i)
+        b[i] = rand() / (value_type(RAND_MAX) + 1);
+
+    stats_type stats;
+    IterativeRefinement<value_type, float> refinement(system_size);
+    int status = refinement(A, A_low, &b[0], &f[0], 1e-12, &stats);
+
+    A(&f[0], &r[0]);
+    value_type error = 0, bnorm = 0;
+    for(size_t i = 0; i < system_size; ++i)
+    {
+        error += (r[i] - b[i]) * (r[i] - b[i]);
+        bnorm += b[i] * b[i];
+    }
+    error = std::sqrt(error / bnorm);
+
+    for(stats_type::iterator s = stats.begin(); s != stats.end(); ++s)
+    {
+        std::cout << s->first << " = [";
+        std::copy(s->second.begin(), s->second.end(), std::ostream_iterator<value_type>(std::cout, " "));
+        std::cout << "];\n";
+    }
+    std::cout << "relative residual = " << error << std::endl;
+
+    return (status == 0 && error < 1e-11) ? 0 : 1;
+}
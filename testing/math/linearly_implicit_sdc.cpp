@@ -0,0 +1,65 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Brusselator with the nonlinear reaction and the diffusion implicit, counting the evaluations of
+ * the implicit part.
+ **/
+template<size_t size>
+struct implicit_brusselator : public diffusion_type<double, size>
+{
+    size_t implicit_calls;
+    implicit_brusselator() : implicit_calls(0) {}
+    void Explicit(double, const double *, double *v) { std::fill(v, v + size, 0.0); }
+    void Implicit(double t, const double *x, double *v)
+    {
+        ++implicit_calls;
+        (*this)(t, x, v);
+    }
+};
+
+template<typename sdc_type, typename function_type>
+size_t brusselator(function_type &F, bool linear, std::vector<double> &x, int steps, double dt)
+{
+    sdc_type *sdc = new sdc_type(F.ode_size());
+    if(linear)
+        sdc->setLinearlyImplicit(true);
+    std::vector<double> v(F.ode_size());
+    F.init(0, 1, &x[0]);
+    F.implicit_calls = 0;
+    for(int i = 0; i < steps; ++i)
+        (*sdc)(F, i * dt, &x[0], &v[0], dt);
+    delete sdc;
+    return F.implicit_calls;
+}
+
+int linearly_implicit_sdc(int , char **)
+{
+    typedef double value_type;
+    typedef Integrator<value_type, gauss_lobatto, 3> spectral_integrator;
+    typedef SemiImplicitSDC<value_type, spectral_integrator, 8> sdc_type;
+    enum { ode_size = 40 };
+
+    implicit_brusselator<ode_size> F;
+    const int steps = 50;
+    const value_type dt = .02;
+    std::vector<value_type> x[2] = {std::vector<value_type>(ode_size), std::vector<value_type>(ode_size)};
+    size_t newton_calls = brusselator<sdc_type>(F, false, x[0], steps, dt);
+    size_t linear_calls = brusselator<sdc_type>(F, true, x[1], steps, dt);
+
+    value_type difference = 0;
+    for(int i = 0; i < ode_size; ++i)
+        difference = std::max(difference, std::fabs(x[1][i] - x[0][i]));
+    std::cout << "Newton: " << newton_calls << " implicit evaluations, linearly implicit: " << linear_calls
+              << ", difference = " << difference << std::endl;
+
+    if(difference > 1e-8 || linear_calls >= newton_calls)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/sdc/low_storage_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Steps the diffusion problem and returns the largest component of the solution.
+ **/
+template<typename sdc_type, typename function_type>
+double run(function_type &F, double *x, int steps, double dt)
+{
+    sdc_type *sdc = new sdc_type(F.ode_size());
+    std::vector<double> v(F.ode_size());
+    double t = 0;
+    for(int i = 0; i < steps; ++i, t += dt)
+        (*sdc)(F, t, x, &v[0], dt);
+    delete sdc;
+    return *std::max_element(x, x + F.ode_size());
+}
+
+int low_storage_sdc(int , char **)
+{
+    typedef double value_type;
+    enum
+    {
+        sdc_nodes = 5,
+        sdc_corrections = 8,
+        spatial_size = 40,
+        ode_size = 2 * spatial_size
+    };
+    typedef Integrator<value_type, gauss_lobatto, sdc_nodes> spectral_integrator;
+    typedef SemiImplicitSDC<value_type, spectral_integrator, sdc_corrections> reference_type;
+    typedef LowStorageSDC<value_type, spectral_integrator, sdc_corrections> low_storage_type;
+    typedef LowStorageSDC<value_type, spectral_integrator, sdc_corrections, float> single_storage_type;
+
+    diffusion_type<value_type, ode_size> F;
+    value_type x[3][ode_size];
+    for(int k = 0; k < 3; ++k)
+        F.init(0, 1, x[k]);
+
+    const int steps = 50;
+    const value_type dt = .01;
+    run<reference_type>(F, x[0], steps, dt);
+    double scale = run<low_storage_type>(F, x[1], steps, dt);
+    run<single_storage_type>(F, x[2], steps, dt);
+
+    double difference[2] = {0, 0};
+    for(int j = 0; j < ode_size; ++j)
+        for(int k = 0; k < 2; ++k)
+            difference[k] = std::max(difference[k], std::fabs(x[k + 1][j] - x[0][j]));
+
+    /// The implicit solvers, the same in both, are not counted
+    reference_type *reference = new reference_type(ode_size);
+    size_t reference_storage = reference->storage();
+    delete reference;
+    low_storage_type *low_storage = new low_storage_type(ode_size);
+    single_storage_type *single_storage = new single_storage_type(ode_size);
+    size_t storage[2] = {low_storage->storage(), single_storage->storage()};
+    delete low_storage;
+    delete single_storage;
+
+    std::cout << "low storage: difference = " << difference[0] << ", storage = " << double(storage[0]) / reference_storage << std::endl;
+    std::cout << "float right hand sides: difference = " << difference[1] << ", storage = " << double(storage[1]) / reference_storage << std::endl;
+
+    if(difference[0] > 1e-12 * (1 + scale) || difference[1] > 1e-7 * (1 + scale))
+        return 1;
+    if(storage[0] >= reference_storage || storage[1] >= storage[0])
+        return 1;
+    return 0;
+}
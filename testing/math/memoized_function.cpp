@@ -0,0 +1,98 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "utils/memoized_function.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Brusselator counting the evaluations of the right hand side and the accuracy requests.
+ **/
+template<size_t size>
+struct counted_brusselator : public diffusion_type<double, size>
+{
+    typedef diffusion_type<double, size> base_type;
+    size_t calls;
+    double accuracy;
+    counted_brusselator() : calls(0), accuracy(0) {}
+    void operator()(double t, const double *x, double *v) { ++calls; base_type::operator()(t, x, v); }
+    void Explicit(double t, const double *x, double *v) { ++calls; base_type::Explicit(t, x, v); }
+    void Implicit(double t, const double *x, double *v) { ++calls; base_type::Implicit(t, x, v); }
+    void setAccuracy(double tol) { accuracy = tol; }
+};
+
+/**
+ * Steps of an adaptive driver, every step is first tried with 2*dt and rejected.
+ **/
+template<typename sdc_type, typename function_type>
+void rejected_steps(function_type &F, bool linear, std::vector<double> &x, int steps, double dt)
+{
+    sdc_type *sdc = new sdc_type(x.size());
+    sdc->setLinearlyImplicit(linear);
+    std::vector<double> v(x.size()), saved(x);
+    for(int i = 0; i < steps; ++i)
+    {
+        saved = x;
+        (*sdc)(F, i * dt, &x[0], &v[0], 2 * dt);
+        x = saved;
+        sdc->reset();
+        (*sdc)(F, i * dt, &x[0], &v[0], dt);
+    }
+    delete sdc;
+}
+
+int memoized_function(int , char **)
+{
+    typedef double value_type;
+    typedef Integrator<value_type, gauss_lobatto, 3> spectral_integrator;
+    typedef SemiImplicitSDC<value_type, spectral_integrator, 4> sdc_type;
+    enum { ode_size = 20 };
+
+    counted_brusselator<ode_size> F;
+    MemoizedFunction<counted_brusselator<ode_size>, value_type> G(F);
+    std::vector<value_type> x[2] = {std::vector<value_type>(ode_size), std::vector<value_type>(ode_size)};
+    bool passed = true;
+    for(int linear = 0; linear < 2; ++linear)
+    {
+        F.init(0, 1, &x[0][0]);
+        F.init(0, 1, &x[1][0]);
+        F.calls = 0;
+        rejected_steps<sdc_type>(F, linear, x[0], 20, .01);
+        size_t calls = F.calls, hits = G.hits();
+        F.calls = 0;
+        G.invalidate();
+        rejected_steps<sdc_type>(G, linear, x[1], 20, .01);
+        size_t memoized_calls = F.calls;
+        hits = G.hits() - hits;
+
+        bool same = std::equal(x[0].begin(), x[0].end(), x[1].begin());
+        std::cout << (linear ? "linearly implicit" : "Newton") << ": evaluations = " << calls << ", memoized = " << memoized_calls
+                  << " (" << hits << " hits), same solution = " << same << std::endl;
+        /// At least the two evaluations at the start of every retried step are saved
+        if(!same || memoized_calls + hits != calls || hits < 2 * 20)
+            passed = false;
+    }
+
+    /// Coarse evaluations are not returned for finer requests
+    std::vector<value_type> v(ode_size), w(ode_size);
+    G.invalidate();
+    F.calls = 0;
+    G.setAccuracy(1e-3);
+    G(0, &x[0][0], &v[0]);
+    G.setAccuracy(1e-8);
+    G(0, &x[0][0], &w[0]);
+    G(0, &x[0][0], &w[0]);
+    G.setAccuracy(1e-3);
+    G(0, &x[0][0], &w[0]);
+    if(F.calls != 2 || F.accuracy != 1e-3)
+        passed = false;
+    G.invalidate();
+    G(0, &x[0][0], &w[0]);
+    if(F.calls != 3)
+        passed = false;
+
+    return passed ? 0 : 1;
+}
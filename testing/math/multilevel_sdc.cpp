@@ -0,0 +1,85 @@
+#include<iostream>
+#include<cmath>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/multilevel_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Counts the evaluations of a right hand side and optionally scales it to mimic a cruder model.
+ **/
+template<typename function_type>
+struct counted_function
+{
+    function_type F;
+    double scale;
+    size_t evaluations;
+    counted_function(double _scale = 1) : scale(_scale), evaluations(0) {}
+
+    template<typename value_type>
+    void operator()(value_type t, const value_type *x, value_type *v)
+    {
+        ++evaluations;
+        F(t, x, v);
+        for(size_t i = 0; i < F.ode_size(); ++i)
+            v[i] *= scale;
+    }
+    size_t ode_size() { return F.ode_size(); }
+};
+
+template<typename sdc_type>
+double explicit_error(size_t &evaluations)
+{
+    counted_function<function_type<1> > F;
+    sdc_type sdc(F.ode_size());
+    double x = 1, v, t = 0, dt = .25;
+    F(t, &x, &v);
+    for(int i = 0; i < 8; ++i, t += dt)
+        sdc(F, t, &x, &v, dt);
+    evaluations = F.evaluations;
+    return std::fabs(x - std::exp(std::sin(t)));
+}
+
+template<typename sdc_type>
+double multilevel_error(size_t &evaluations, double coarse_scale)
+{
+    counted_function<function_type<1> > F, G(coarse_scale);
+    sdc_type sdc(F.ode_size());
+    double x = 1, v, t = 0, dt = .25;
+    F(t, &x, &v);
+    for(int i = 0; i < 8; ++i, t += dt)
+        sdc(F, G, t, &x, &v, dt);
+    evaluations = F.evaluations;
+    return std::fabs(x - std::exp(std::sin(t)));
+}
+
+int multilevel_sdc(int , char **)
+{
+    typedef double value_type;
+    typedef Integrator<value_type, gauss_lobatto, 5> fine_integrator;
+    typedef Integrator<value_type, gauss_lobatto, 3> coarse_integrator;
+
+    size_t sdc2_evaluations, sdc4_evaluations, mlsdc_evaluations, perturbed_evaluations, converged_evaluations, collocation_evaluations;
+    /// Two and four fine sweeps of plain SDC
+    value_type sdc2 = explicit_error<ExplicitSDC<value_type, fine_integrator, 3> >(sdc2_evaluations);
+    value_type sdc4 = explicit_error<ExplicitSDC<value_type, fine_integrator, 5> >(sdc4_evaluations);
+    /// Two fine sweeps with a coarse correction in between
+    value_type mlsdc = multilevel_error<MultilevelSDC<value_type, fine_integrator, coarse_integrator, 3, 2> >(mlsdc_evaluations, 1);
+    /// A coarse model 10% off, the FAS correction keeps the fine solution
+    value_type perturbed = multilevel_error<MultilevelSDC<value_type, fine_integrator, coarse_integrator, 3, 2> >(perturbed_evaluations, .9);
+    value_type converged = multilevel_error<MultilevelSDC<value_type, fine_integrator, coarse_integrator, 8, 2> >(converged_evaluations, .9);
+    value_type collocation = explicit_error<ExplicitSDC<value_type, fine_integrator, 12> >(collocation_evaluations);
+
+    std::cout << "sdc, 2 sweeps:          error = " << sdc2 << ", fine evaluations = " << sdc2_evaluations << std::endl;
+    std::cout << "sdc, 4 sweeps:          error = " << sdc4 << ", fine evaluations = " << sdc4_evaluations << std::endl;
+    std::cout << "mlsdc, 2 sweeps:        error = " << mlsdc << ", fine evaluations = " << mlsdc_evaluations << std::endl;
+    std::cout << "mlsdc, perturbed G:     error = " << perturbed << ", fine evaluations = " << perturbed_evaluations << std::endl;
+    std::cout << "mlsdc, 7 sweeps:        error = " << converged << ", collocation error = " << collocation << std::endl;
+
+    if(mlsdc > .1 * sdc2 || mlsdc_evaluations >= sdc4_evaluations)
+        return 1;
+    if(std::fabs(converged - collocation) > 1e-12)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include<iostream>
+#include<cmath>
+#include<limits>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/integrator/lagrange_polynomial.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/multirate_sdc.hpp"
+
+/**
+ * x' = cos(t) + lambda*(sin(t) - x), x(0) = 1, x(t) = sin(t) + exp(-lambda*t).  The stiff
+ * relaxation is the cheap fast part, the forcing stands for the expensive slow part.
+ **/
+struct relaxation
+{
+    double lambda;
+    size_t slow_evaluations;
+    relaxation() : lambda(200), slow_evaluations(0) {}
+
+    template<typename value_type>
+    void operator()(value_type t, const value_type *x, value_type *v)
+    {
+        ++slow_evaluations;
+        v[0] = std::cos(t) + lambda * (std::sin(t) - x[0]);
+    }
+    template<typename value_type>
+    void Explicit(value_type t, const value_type *, value_type *v)
+    {
+        ++slow_evaluations;
+        v[0] = std::cos(t);
+    }
+    template<typename value_type>
+    void Implicit(value_type t, const value_type *x, value_type *v)
+    {
+        v[0] = lambda * (std::sin(t) - x[0]);
+    }
+    size_t ode_size() { return 1; }
+    double exact(double t) { return std::sin(t) + std::exp(-lambda * t); }
+};
+
+int multirate(int , char **)
+{
+    typedef double value_type;
+    {
+        /// Integrals of the Lagrange basis of the Gauss-Lobatto nodes reproduce the quadrature matrix
+        GaussLobatto<value_type, 5> rule;
+        value_type nodes[5];
+        for(int j = 0; j < 5; ++j)
+            nodes[j] = rule.node(j);
+        LagrangePolynomial<value_type> l(nodes, 5);
+        value_type error = 0;
+        for(int i = 0; i < 4; ++i)
+            for(int j = 0; j < 5; ++j)
+            {
+                error = std::max(error, std::fabs(l.integral(j, nodes[i], nodes[i + 1]) - rule.matrix(i, j)));
+                error = std::max(error, std::fabs(l(j, nodes[i]) - value_type(i == j)));
+            }
+        std::cout << "lagrange error = " << error << std::endl;
+        if(error > 1e-14)
+            return 1;
+    }
+
+    const value_type T = 1, dt = .05;
+    const int steps = int(T / dt + .5);
+    value_type multirate_error = 0, explicit_error = 0;
+    size_t multirate_slow = 0, explicit_slow = 0;
+    {
+        relaxation F;
+        MultirateSDC<value_type, Integrator<value_type, gauss_lobatto, 5, 9>, 6> sdc(F.ode_size());
+        value_type x = 1, v = 0, t = 0;
+        for(int i = 0; i < steps; ++i, t += dt)
+            sdc(F, t, &x, &v, dt);
+        multirate_error = std::fabs(x - F.exact(T));
+        multirate_slow = F.slow_evaluations;
+    }
+    {
+        /// Same step and number of slow evaluations without substeps
+        relaxation F;
+        ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 6> sdc(F.ode_size());
+        value_type x = 1, v = 0, t = 0;
+        F(t, &x, &v);
+        sdc.setThrowOnDivergence(false);
+        for(int i = 0; i < steps && !sdc.diverged(); ++i, t += dt)
+            sdc(F, t, &x, &v, dt);
+        explicit_error = sdc.diverged() ? std::numeric_limits<value_type>::infinity() : std::fabs(x - F.exact(T));
+        explicit_slow = F.slow_evaluations;
+    }
+    std::cout << "multirate: error = " << multirate_error << ", slow evaluations = " << multirate_slow << std::endl;
+    std::cout << "explicit:  error = " << explicit_error << ", slow evaluations = " << explicit_slow << std::endl;
+    if(multirate_error > 1e-6 || explicit_error < 1e3 * multirate_error)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include<iostream>
+#include<cmath>
+#include<limits>
+#include<stdexcept>
+#include<map>
+#include<string>
+#include<vector>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/sdc/parallel_sdc.hpp"
+
+/**
+ * x' = cos(t) + lambda*(sin(t) - x), x(0) = 1.  The relaxation is the implicit part.
+ **/
+struct stiff_relaxation
+{
+    double lambda;
+    stiff_relaxation(double _lambda) : lambda(_lambda) {}
+
+    template<typename value_type>
+    void operator()(value_type t, const value_type *x, value_type *v)
+    {
+        v[0] = std::cos(t) + lambda * (std::sin(t) - x[0]);
+    }
+    template<typename value_type>
+    void Explicit(value_type t, const value_type *, value_type *v)
+    {
+        v[0] = std::cos(t);
+    }
+    template<typename value_type>
+    void Implicit(value_type t, const value_type *x, value_type *v)
+    {
+        v[0] = lambda * (std::sin(t) - x[0]);
+    }
+    size_t ode_size() { return 1; }
+};
+
+template<typename sdc_type>
+double solve(sdc_type &sdc, double lambda)
+{
+    stiff_relaxation F(lambda);
+    double x = 1, v, t = 0, dt = .1;
+    try
+    {
+        for(int i = 0; i < 10; ++i, t += dt)
+            sdc(F, t, &x, &v, dt);
+    }
+    catch(std::out_of_range &)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return x;
+}
+
+template<int sdc_corrections>
+double difference(diagonal_preconditioner type, double lambda, double reference, bool parallel = true)
+{
+    ParallelSDC<double, Integrator<double, gauss_radau, 5>, sdc_corrections> sdc(1);
+    sdc.setPreconditioner(type);
+    sdc.setNodeParallel(parallel);
+    return std::fabs(solve(sdc, lambda) - reference);
+}
+
+int parallel_sdc(int , char **)
+{
+    typedef double value_type;
+    typedef Integrator<value_type, gauss_radau, 5> spectral_integrator;
+    const diagonal_preconditioner types[4] = {PICARD, IMPLICIT_EULER, MIN_SR_NS, MIN_SR_FLEX};
+    const char *names[4] = {"picard", "implicit euler", "min-sr-ns", "min-sr-flex"};
+    const value_type lambdas[2] = {1, 1000};
+    /// Largest difference with the collocation solution after 8 sweeps
+    const value_type tolerances[2][4] = {{1e-12, 1e-10, 1e-12, 1e-12}, {0, 1e-6, 0, 1e-6}};
+
+    for(int l = 0; l < 2; ++l)
+    {
+        SemiImplicitSDC<value_type, spectral_integrator, 30> reference_sdc(1);
+        value_type reference = solve(reference_sdc, lambdas[l]);
+        std::cout << "lambda = " << lambdas[l] << ", difference after 2, 4, 6 and 8 sweeps" << std::endl;
+        for(int p = 0; p < 4; ++p)
+        {
+            /// Picard and MIN-SR-NS diverge for the stiff problem
+            if(tolerances[l][p] == 0)
+                continue;
+            value_type d[4] = {difference<3>(types[p], lambdas[l], reference),
+                               difference<5>(types[p], lambdas[l], reference),
+                               difference<7>(types[p], lambdas[l], reference),
+                               difference<9>(types[p], lambdas[l], reference)
+                              };
+            std::cout << "  " << names[p] << ": " << d[0] << " " << d[1] << " " << d[2] << " " << d[3] << std::endl;
+            if(!(d[3] < tolerances[l][p]) || !(d[3] < d[0]))
+                return 1;
+        }
+    }
+
+    /// The node updates are independent, running them serially gives the same result
+    value_type parallel = difference<5>(MIN_SR_FLEX, 1000, 0), serial = difference<5>(MIN_SR_FLEX, 1000, 0, false);
+    std::cout << "parallel = " << parallel << ", serial = " << serial << std::endl;
+    if(parallel != serial)
+        return 1;
+
+    /// The predictor asks for the coarsest accuracy, the first sweep for one relative to the
+    /// residual of the predictor of the step
+    ParallelSDC<value_type, spectral_integrator, 5> adaptive(1);
+    std::map<std::string, std::vector<value_type> > stats;
+    adaptive.setPreconditioner(MIN_SR_FLEX);
+    adaptive.setAdaptiveAccuracy(.1, 1, 1e-14);
+    adaptive.setStatistics(&stats);
+    stiff_relaxation F(1);
+    value_type x = 1, v, predictor_residual[2], requested[2], predictor_requested[2];
+    for(int i = 0; i < 2; ++i)
+    {
+        stats.clear();
+        adaptive(F, i * .1, &x, &v, i == 0 ? .1 : .05);
+        predictor_residual[i] = adaptive.residual(0);
+        predictor_requested[i] = stats["sdc_accuracy"][0];
+        requested[i] = stats["sdc_accuracy"][1];
+    }
+    std::cout << "predictor residuals = " << predictor_residual[0] << " " << predictor_residual[1]
+              << ", first sweep accuracies = " << requested[0] << " " << requested[1] << std::endl;
+    for(int i = 0; i < 2; ++i)
+        if(!(predictor_residual[i] > adaptive.residual()) || requested[i] != .1 * predictor_residual[i] || predictor_requested[i] != 1)
+            return 1;
+    if(predictor_residual[0] == predictor_residual[1])
+        return 1;
+    return 0;
+}
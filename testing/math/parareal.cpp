@@ -0,0 +1,69 @@
+#include<iostream>
+#include<cmath>
+#include<map>
+#include<string>
+#include<vector>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/parareal/parareal.hpp"
+
+/**
+ * Lotka-Volterra predator-prey model.
+ **/
+struct lotka_volterra
+{
+    template<typename value_type>
+    void operator()(value_type , const value_type *x, value_type *v)
+    {
+        v[0] = x[0] * (1.5 - x[1]);
+        v[1] = x[1] * (x[0] - 3);
+    }
+    size_t ode_size() { return 2; }
+};
+
+int parareal(int , char **)
+{
+    typedef double value_type;
+    typedef ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 5> fine_propagator;
+    typedef ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 3>, 2> coarse_propagator;
+    const int num_slices = 8, slice_steps = 25;
+    const value_type dt = .01;
+
+    lotka_volterra F;
+    {
+        std::map<std::string, std::vector<value_type> > stats;
+        Parareal<value_type, fine_propagator, coarse_propagator> solver(F.ode_size(), num_slices, slice_steps, 5);
+        solver.setTolerance(1e-12);
+        solver.setSerialCheck(true);
+        solver.setStatistics(&stats);
+        value_type x[2] = {1, 1}, v[2], t = 0;
+        int iterations = 0;
+        for(int window = 0; window < 2; ++window, t += solver.window(dt))
+        {
+            iterations += solver(F, t, x, v, dt);
+            std::cout << "window " << window << ": iterations = " << stats["parareal_iterations"].back()
+                      << ", serial difference = " << solver.serial_difference() << std::endl;
+            if(solver.serial_difference() > 1e-10)
+                return 1;
+        }
+        std::cout << "defects = [";
+        for(size_t i = 0; i < stats["parareal_defect"].size(); ++i)
+            std::cout << stats["parareal_defect"][i] << " ";
+        std::cout << "]" << std::endl;
+        if(iterations >= 2 * num_slices)
+            return 1;
+    }
+    {
+        /// num_slices iterations reproduce serial stepping
+        Parareal<value_type, fine_propagator, coarse_propagator> solver(F.ode_size(), num_slices, slice_steps);
+        solver.setTolerance(0);
+        solver.setSerialCheck(true);
+        value_type x[2] = {1, 1}, v[2];
+        int iterations = solver(F, value_type(0), x, v, dt);
+        std::cout << "iterations = " << iterations << ", serial difference = " << solver.serial_difference() << std::endl;
+        if(iterations != num_slices || solver.serial_difference() > 1e-13)
+            return 1;
+    }
+    return 0;
+}
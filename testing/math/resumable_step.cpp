@@ -0,0 +1,72 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "rhs_functions.hpp"
+
+/**
+ * Takes steps with operator() and with begin()/resume(), cancelling every other step after a few
+ * pieces, and checks that the solutions are the same and that the state is untouched until the
+ * last piece.
+ **/
+template<typename sdc_type, typename function_type>
+bool compare_steps(function_type &F, const char *name, int steps, double dt, size_t expected_pieces)
+{
+    sdc_type *sdc[2] = {new sdc_type(F.ode_size()), new sdc_type(F.ode_size())};
+    size_t n = F.ode_size();
+    std::vector<double> x[2] = {std::vector<double>(n), std::vector<double>(n)}, v[2] = {std::vector<double>(n), std::vector<double>(n)};
+    F.init(0, 1, &x[0][0]);
+    F.init(0, 1, &x[1][0]);
+    F(0, &x[0][0], &v[0][0]);
+    F(0, &x[1][0], &v[1][0]);
+
+    bool passed = true;
+    for(int i = 0; i < steps; ++i)
+    {
+        (*sdc[0])(F, i * dt, &x[0][0], &v[0][0], dt);
+
+        std::vector<double> x0(x[1]);
+        if(i % 2)
+        {
+            sdc[1]->begin(F, i * dt, &x[1][0], &v[1][0], dt);
+            sdc[1]->resume(F);
+            sdc[1]->resume(F);
+            sdc[1]->cancel();
+            if(sdc[1]->stage() != sdc_type::step_idle || sdc[1]->resume(F))
+                passed = false;
+        }
+        size_t pieces = 0;
+        sdc[1]->begin(F, i * dt, &x[1][0], &v[1][0], dt);
+        while(sdc[1]->resume(F))
+        {
+            ++pieces;
+            if(x[1] != x0)
+                passed = false;
+        }
+        if(pieces + 1 != expected_pieces)
+            passed = false;
+    }
+
+    bool same = x[0] == x[1] && v[0] == v[1];
+    std::cout << name << ": pieces per step = " << expected_pieces << ", same solution = " << same << std::endl;
+    delete sdc[0];
+    delete sdc[1];
+    return passed && same;
+}
+
+int resumable_step(int , char **)
+{
+    typedef Integrator<double, gauss_lobatto, 5> spectral_integrator;
+    typedef ExplicitSDC<double, spectral_integrator, 4> explicit_sdc;
+    typedef SemiImplicitSDC<double, spectral_integrator, 4> implicit_sdc;
+
+    diffusion_type<double, 20> F;
+    /// Four predictor substeps and three sweeps
+    bool passed = compare_steps<explicit_sdc>(F, "explicit", 20, .001, 7);
+    passed = compare_steps<implicit_sdc>(F, "semi-implicit", 20, .01, 7) && passed;
+    return passed ? 0 : 1;
+}
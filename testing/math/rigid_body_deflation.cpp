@@ -0,0 +1,100 @@
+#include<iostream>
+#include<vector>
+#include<map>
+#include<cmath>
+#include<cstdlib>
+#include<limits>
+#include<numeric>
+
+#include "math/fluid_solver/stokes/cpu_stokes_solver.hpp"
+#include "math/linear_solver/krylov/generalized_minimal_residual_method.hpp"
+#include "math/linear_solver/preconditioner/block_jacobi_preconditioner.hpp"
+#include "math/linear_solver/preconditioner/rigid_body_deflation.hpp"
+
+template<typename value_type>
+struct stokeslet_operator
+{
+    CpuStokesSolver<value_type> &m_solver;
+    const value_type *m_x;
+
+    stokeslet_operator(CpuStokesSolver<value_type> &solver, const value_type *x) : m_solver(solver), m_x(x) {}
+
+    inline void operator()(const value_type *f, value_type *v)
+    {
+        m_solver(0, m_x, v, f);
+    }
+};
+
+template<typename value_type, typename preconditioner_type>
+size_t solve(stokeslet_operator<value_type> &A, preconditioner_type &M, const std::vector<value_type> &b, std::vector<value_type> &f)
+{
+    typedef std::map<std::string, std::vector<value_type> > stats_type;
+    GeneralizedMinimalResidualMethod<value_type, 50> gmres(b.size());
+    stats_type stats;
+    std::fill(f.begin(), f.end(), value_type(0));
+    value_type bnorm = std::sqrt(std::inner_product(b.begin(), b.end(), b.begin(), value_type(0)));
+    value_type k_err = std::numeric_limits<value_type>::infinity();
+    for(int k_it = 0; k_err > 1e-8 * bnorm && k_it < 20; ++k_it)
+        k_err = gmres(A, M, &b[0], &f[0], 1e-8, &stats);
+    size_t its = 0;
+    for(size_t i = 0; i < stats["gmres_fn_eval"].size(); ++i)
+        its += stats["gmres_fn_eval"][i];
+    return its;
+}
+
+/**
+ * Solves the stokeslet system of a grid of num_bodies x num_bodies helical towers.
+ * Returns the iterations of block Jacobi and of the two-level preconditioner.
+ **/
+template<typename value_type>
+void run(size_t grid_size, size_t &jacobi_its, size_t &deflation_its)
+{
+    const size_t particles_per_body = 24;
+    const size_t num_bodies = grid_size * grid_size;
+    const size_t num_particles = num_bodies * particles_per_body;
+    const size_t system_size = 3 * num_particles;
+
+    std::vector<value_type> x(system_size);
+    for(size_t b = 0, idx = 0; b < num_bodies; ++b)
+        for(size_t i = 0; i < particles_per_body; ++i, idx += 3)
+        {
+            value_type theta = 2 * M_PI * i / 8;
+            x[idx] = .5 * std::cos(theta) + 1.5 * (b % grid_size);
+            x[idx + 1] = .5 * std::sin(theta) + 1.5 * (b / grid_size);
+            x[idx + 2] = .25 * i;
+        }
+
+    CpuStokesSolver<value_type> solver(num_particles);
+    solver.setDelta(.25);
+    stokeslet_operator<value_type> A(solver, &x[0]);
+
+    srand(0);
+    std::vector<value_type> b(system_size), f(system_size);
+    for(size_t i = 0; i < system_size; ++i)
+        b[i] = rand() / (value_type(RAND_MAX) + 1);
+
+    BlockJacobiPreconditioner<value_type> jacobi(system_size);
+    jacobi.setBodies(num_bodies, particles_per_body);
+    jacobi.update(solver, &x[0]);
+    jacobi_its = solve(A, jacobi, b, f);
+
+    RigidBodyDeflation<value_type> deflation(system_size, jacobi);
+    deflation.setBodies(num_bodies, particles_per_body);
+    deflation.update(solver, &x[0]);
+    deflation_its = solve(A, deflation, b, f);
+}
+
+int rigid_body_deflation(int , char **)
+{
+    typedef double value_type;
+
+    size_t jacobi_small, deflation_small, jacobi_large, deflation_large;
+    run<value_type>(2, jacobi_small, deflation_small);
+    run<value_type>(4, jacobi_large, deflation_large);
+
+    std::cout << "4 bodies: block jacobi = " << jacobi_small << ", two-level = " << deflation_small << std::endl;
+    std::cout << "16 bodies: block jacobi = " << jacobi_large << ", two-level = " << deflation_large << std::endl;
+
+    bool passed = deflation_small <= jacobi_small && deflation_large < jacobi_large;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+#include<iostream>
+#include<vector>
+#include<cmath>
+
+#include "math/ode_solver/euler/backward_euler.hpp"
+#include "math/linear_solver/krylov/generalized_minimal_residual_method.hpp"
+#include "math/linear_solver/krylov/projection_predictor.hpp"
+
+/**
+ * Forced reaction-diffusion equation, u' = c*L*u - u^3 + sin(t).  Counts the function evaluations.
+ **/
+struct forced_reaction_diffusion
+{
+    size_t m_size;
+    size_t m_evals;
+
+    forced_reaction_diffusion(size_t size) : m_size(size), m_evals(0) {}
+
+    template<typename value_type>
+    void operator()(value_type t, const value_type *x, value_type *Fx)
+    {
+        ++m_evals;
+        value_type c = 100;
+        for(size_t i = 0; i < m_size; ++i)
+        {
+            value_type left = i > 0 ? x[i - 1] : value_type(0);
+            value_type right = i < m_size - 1 ? x[i + 1] : value_type(0);
+            Fx[i] = c * (left - 2 * x[i] + right) - x[i] * x[i] * x[i] + std::sin(t);
+        }
+    }
+};
+
+/**
+ * Takes num_steps backward Euler steps and returns the total number of function evaluations.
+ **/
+template<typename value_type>
+size_t euler_steps(int extrapolation, std::vector<value_type> &x)
+{
+    const size_t size = x.size();
+    const int num_steps = 50;
+    forced_reaction_diffusion F(size);
+    BackwardEuler<value_type, 50, 10> euler(size);
+    euler.setTolerances(1e-10, 0);
+    euler.setExtrapolation(extrapolation);
+    std::vector<value_type> v(size);
+    for(size_t i = 0; i < size; ++i)
+        x[i] = std::sin(M_PI * (i + 1) / (size + 1));
+    value_type t = 0, dt = 1e-2;
+    for(int step = 0; step < num_steps; ++step)
+    {
+        t += dt;
+        euler(F, t, &x[0], &v[0], dt);
+    }
+    return F.m_evals;
+}
+
+/**
+ * 1D Laplacian plus a multiple of the identity.
+ **/
+struct shifted_laplacian
+{
+    size_t m_size;
+    shifted_laplacian(size_t size) : m_size(size) {}
+
+    template<typename value_type>
+    void operator()(const value_type *x, value_type *Ax)
+    {
+        for(size_t i = 0; i < m_size; ++i)
+        {
+            value_type left = i > 0 ? x[i - 1] : value_type(0);
+            value_type right = i < m_size - 1 ? x[i + 1] : value_type(0);
+            Ax[i] = value_type(2.1) * x[i] - left - right;
+        }
+    }
+};
+
+/**
+ * GMRES matrix-vector products for a sequence of solves with slowly moving right hand sides, each
+ * started from zero or from the projection onto the previous solves.
+ **/
+template<typename value_type>
+size_t gmres_sequence(bool projection)
+{
+    const size_t size = 100;
+    const int num_solves = 20;
+    shifted_laplacian A(size);
+    GeneralizedMinimalResidualMethod<value_type, 100> gmres(size);
+    ProjectionPredictor<value_type> predictor(size, 3);
+    std::map<std::string, std::vector<value_type> > stats;
+    std::vector<value_type> b(size), x(size);
+    for(int k = 0; k < num_solves; ++k)
+    {
+        for(size_t i = 0; i < size; ++i)
+            b[i] = std::sin(M_PI * (i + 1) / (size + 1) + .05 * k) + .1 * std::cos(.3 * i - .02 * k);
+        if(projection)
+            predictor.predict(&b[0], &x[0]);
+        else
+            std::fill(x.begin(), x.end(), value_type(0));
+        gmres(A, &b[0], &x[0], value_type(1e-10), &stats);
+        predictor.record(&b[0], &x[0]);
+    }
+    size_t evals = 0;
+    for(size_t i = 0; i < stats["gmres_fn_eval"].size(); ++i)
+        evals += stats["gmres_fn_eval"][i];
+    return evals;
+}
+
+int solution_predictors(int , char **)
+{
+    typedef double value_type;
+
+    /// A quadratic in time is extrapolated exactly, going back in time restarts the history
+    {
+        ExtrapolationPredictor<value_type> predictor(2, 2);
+        value_type x[2] = {0, 0};
+        for(int k = 0; k < 3; ++k)
+        {
+            value_type t = .1 * k;
+            value_type y[2] = {t * t, 1 - t};
+            predictor.record(t, y);
+        }
+        predictor.predict(.3, x);
+        if(std::fabs(x[0] - .09) > 1e-14 || std::fabs(x[1] - .7) > 1e-14)
+            return 1;
+        value_type y[2] = {.01, .9};
+        predictor.record(.1, y);
+        if(predictor.predict(.05, x))
+            return 1;
+    }
+
+    /// For a fixed matrix the projection reproduces solutions in the span of the history
+    {
+        const size_t n = 3;
+        value_type A[n][n] = {{4, 1, 0}, {1, 3, 1}, {0, 1, 2}};
+        ProjectionPredictor<value_type> predictor(n, 2);
+        value_type x1[n] = {1, 0, 0}, x2[n] = {0, 1, 1}, b1[n], b2[n], b[n], x[n];
+        for(size_t i = 0; i < n; ++i)
+        {
+            b1[i] = b2[i] = 0;
+            for(size_t j = 0; j < n; ++j)
+            {
+                b1[i] += A[i][j] * x1[j];
+                b2[i] += A[i][j] * x2[j];
+            }
+            b[i] = 2 * b1[i] - b2[i];
+        }
+        predictor.record(b1, x1);
+        predictor.record(b2, x2);
+        predictor.predict(b, x);
+        for(size_t i = 0; i < n; ++i)
+            if(std::fabs(x[i] - (2 * x1[i] - x2[i])) > 1e-13)
+                return 1;
+    }
+
+    const size_t size = 40;
+    std::vector<value_type> x(size), x_extrapolation(size);
+    size_t cold_evals = euler_steps(0, x);
+    size_t extrapolation_evals = euler_steps(2, x_extrapolation);
+    std::cout << "function evaluations: cold start = " << cold_evals << ", extrapolation = " << extrapolation_evals << std::endl;
+
+    value_type diff = 0;
+    for(size_t i = 0; i < size; ++i)
+        diff = std::max(diff, std::fabs(x[i] - x_extrapolation[i]));
+    std::cout << "max difference = " << diff << std::endl;
+    if(extrapolation_evals >= cold_evals || diff > 1e-8)
+        return 1;
+
+    size_t zero_start = gmres_sequence<value_type>(false);
+    size_t projected_start = gmres_sequence<value_type>(true);
+    std::cout << "gmres matrix-vector products: zero start = " << zero_start << ", projection = " << projected_start << std::endl;
+    if(projected_start >= zero_start)
+        return 1;
+    return 0;
+}
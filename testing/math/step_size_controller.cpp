@@ -0,0 +1,89 @@
+#include<iostream>
+#include<cmath>
+#include<algorithm>
+#include<limits>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/step_control/step_size_controller.hpp"
+
+/**
+ * Van der Pol oscillator, x'' = mu*(1 - x^2)*x' - x.  Slow drifts alternate with fast jumps,
+ * so a fixed step has to resolve the jumps all the time.
+ **/
+struct van_der_pol
+{
+    template<typename value_type>
+    void operator()(value_type , const value_type *x, value_type *v)
+    {
+        value_type mu = 5;
+        v[0] = x[1];
+        v[1] = mu * (1 - x[0] * x[0]) * x[1] - x[0];
+    }
+    size_t ode_size() { return 2; }
+};
+
+template<typename value_type>
+value_type fixed_steps(value_type T, int steps, value_type *x)
+{
+    van_der_pol F;
+    ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 5> sdc(2);
+    value_type v[2], t = 0, dt = T / steps;
+    x[0] = 2;
+    x[1] = 0;
+    F(t, x, v);
+    for(int i = 0; i < steps; ++i, t += dt)
+        sdc(F, t, x, v, dt);
+    return x[0];
+}
+
+int step_size_controller(int , char **)
+{
+    typedef double value_type;
+    const value_type T = 20;
+    value_type reference[2], x_fixed[2];
+    fixed_steps(T, 50000, reference);
+
+    /// Same loop as Surface::run(timestep,controller)
+    van_der_pol F;
+    ExplicitSDC<value_type, Integrator<value_type, gauss_lobatto, 5>, 5> sdc(2);
+    StepSizeController<value_type> controller(1e-8, 1e-8);
+    controller.setStepLimits(1e-6, 1);
+    /// The first trial step is far too large, its sweeps diverge and it has to be rejected
+    sdc.setThrowOnDivergence(false);
+    value_type x[2] = {2, 0}, v[2], t = 0, dt = 2;
+    size_t diverged = 0;
+    F(t, x, v);
+    while(t < T)
+    {
+        value_type x0[2] = {x[0], x[1]}, v0[2] = {v[0], v[1]};
+        while(true)
+        {
+            value_type step = std::min(dt, T - t);
+            dt = step;
+            sdc(F, t, x, v, step);
+            value_type err = std::numeric_limits<value_type>::infinity();
+            if(!sdc.diverged())
+                err = controller.error(x, sdc.previous_sweep(), 2);
+            else
+                ++diverged;
+            if(controller.update(err, sdc.estimate_order(), dt))
+            {
+                t += step;
+                break;
+            }
+            std::copy(x0, x0 + 2, x);
+            std::copy(v0, v0 + 2, v);
+            sdc.reset();
+        }
+    }
+    value_type adaptive_error = std::max(std::fabs(x[0] - reference[0]), std::fabs(x[1] - reference[1]));
+    size_t steps = controller.accepted() + controller.rejected();
+    fixed_steps(T, int(steps), x_fixed);
+    value_type fixed_error = std::max(std::fabs(x_fixed[0] - reference[0]), std::fabs(x_fixed[1] - reference[1]));
+    std::cout << "adaptive: " << controller.accepted() << " steps, " << controller.rejected() << " rejected (" << diverged << " diverged), error = " << adaptive_error << std::endl;
+    std::cout << "fixed: " << steps << " steps, error = " << fixed_error << std::endl;
+    if(adaptive_error > 1e-5 || !(fixed_error > 10 * adaptive_error) || diverged == 0)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<map>
+#include<string>
+#include<algorithm>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/sdc/stiffness_switching_sdc.hpp"
+
+/**
+ * Prothero-Robinson system x_i' = s_i*lambda(t)*(x_i - sin(t)) + cos(t), s_i = (i+1)/size.  The
+ * stiffness rho = |lambda| rises from 1 to 1000 and back around t = 3.
+ **/
+struct transient_stiffness
+{
+    enum { size = 10 };
+    static double lambda(double t) { return -1 - 999 * std::exp(-(t - 3) * (t - 3)); }
+
+    void operator()(double t, const double *x, double *v)
+    {
+        Implicit(t, x, v);
+        for(int i = 0; i < size; ++i)
+            v[i] += std::cos(t);
+    }
+    void Explicit(double t, const double *, double *v)
+    {
+        std::fill(v, v + size, std::cos(t));
+    }
+    void Implicit(double t, const double *x, double *v)
+    {
+        for(int i = 0; i < size; ++i)
+            v[i] = (i + 1.) / size * lambda(t) * (x[i] - std::sin(t));
+    }
+    size_t ode_size() { return size; }
+};
+
+int stiffness_switching_sdc(int , char **)
+{
+    typedef double value_type;
+    typedef Integrator<value_type, gauss_lobatto, 3> spectral_integrator;
+    typedef ExplicitSDC<value_type, spectral_integrator, 2> explicit_sdc;
+    typedef SemiImplicitSDC<value_type, spectral_integrator, 2> implicit_sdc;
+    typedef StiffnessSwitchingSDC<value_type, explicit_sdc, implicit_sdc> switching_sdc;
+
+    transient_stiffness F;
+    const int size = transient_stiffness::size;
+    std::map<std::string, std::vector<value_type> > stats;
+    switching_sdc *sdc = new switching_sdc(size);
+    sdc->setCheckInterval(2);
+    sdc->setStatistics(&stats);
+
+    value_type x[size], v[size], t = 0, dt = .05;
+    std::fill(x, x + size, 0.0);
+    F(t, x, v);
+    int stiff_steps = 0;
+    value_type first_stiff = -1, last_stiff = -1;
+    for(int i = 0; i < 120; ++i, t += dt)
+    {
+        (*sdc)(F, t, x, v, dt);
+        if(sdc->stiff())
+        {
+            ++stiff_steps;
+            if(first_stiff < 0)
+                first_stiff = t;
+            last_stiff = t;
+        }
+    }
+
+    value_type error = 0;
+    for(int i = 0; i < size; ++i)
+        error = std::max(error, std::fabs(x[i] - std::sin(t)));
+    /// Power iteration estimate against the exact spectral radius at the last check
+    value_type rho_error = std::fabs(sdc->spectral_radius() - std::fabs(transient_stiffness::lambda(t - 2 * dt))) / std::fabs(transient_stiffness::lambda(t - 2 * dt));
+    std::cout << "stiff steps = " << stiff_steps << " in [" << first_stiff << ", " << last_stiff << "], checks = " << stats["stiff"].size()
+              << ", error = " << error << ", spectral radius error = " << rho_error << std::endl;
+    delete sdc;
+
+    /// rho*dt = 2 is crossed at t = 1.2 and t = 4.8, and 1 at t = 5.2 on the way down
+    if(stiff_steps == 0 || first_stiff < 1 || first_stiff > 1.5 || last_stiff < 4.5 || last_stiff > 5.5)
+        return 1;
+    if(!(error < 1e-3) || rho_error > .2)
+        return 1;
+    return 0;
+}
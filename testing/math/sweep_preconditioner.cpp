@@ -0,0 +1,77 @@
+#include<iostream>
+#include<cmath>
+#include<map>
+#include<string>
+#include<vector>
+
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+
+/**
+ * x' = cos(t) + lambda*(sin(t) - x), x(0) = 1, the relaxation is the implicit part.
+ **/
+struct relaxation_function
+{
+    double lambda;
+    relaxation_function(double _lambda) : lambda(_lambda) {}
+
+    template<typename value_type>
+    void Explicit(value_type t, const value_type *, value_type *v)
+    {
+        v[0] = std::cos(t);
+    }
+    template<typename value_type>
+    void Implicit(value_type t, const value_type *x, value_type *v)
+    {
+        v[0] = lambda * (std::sin(t) - x[0]);
+    }
+    size_t ode_size() { return 1; }
+};
+
+/**
+ * Steps until the sweep residual is below 1e-12, returns the mean number of sweeps per step.
+ **/
+template<typename sweep_type>
+double mean_sweeps(double lambda, double &x)
+{
+    typedef Integrator<double, gauss_radau, 5> spectral_integrator;
+    std::map<std::string, std::vector<double> > stats;
+    relaxation_function F(lambda);
+    SemiImplicitSDC<double, spectral_integrator, 40, sweep_type> sdc(F.ode_size());
+    sdc.setTolerance(1e-12);
+    sdc.setStatistics(&stats);
+    double t = 0, dt = .1, v;
+    x = 1;
+    for(int i = 0; i < 10; ++i, t += dt)
+        sdc(F, t, &x, &v, dt);
+    std::vector<double> &sweeps = stats["sdc_sweeps"];
+    double sum = 0;
+    for(size_t i = 0; i < sweeps.size(); ++i)
+        sum += sweeps[i];
+    return sum / sweeps.size();
+}
+
+int sweep_preconditioner(int , char **)
+{
+    const double lambdas[2] = {1, 1000};
+    for(int l = 0; l < 2; ++l)
+    {
+        double x_ie, x_lu, x_ns, x_flex;
+        double ie = mean_sweeps<ImplicitEulerSweep>(lambdas[l], x_ie);
+        double lu = mean_sweeps<LUSweep>(lambdas[l], x_lu);
+        double ns = lambdas[l] > 1 ? 0 : mean_sweeps<MinSRNSSweep>(lambdas[l], x_ns);
+        double flex = mean_sweeps<MinSRFlexSweep>(lambdas[l], x_flex);
+        std::cout << "lambda = " << lambdas[l] << ", mean sweeps: implicit euler = " << ie << ", lu = " << lu;
+        if(ns > 0)
+            std::cout << ", min-sr-ns = " << ns;
+        std::cout << ", min-sr-flex = " << flex << std::endl;
+        std::cout << "  difference with implicit euler: lu = " << std::fabs(x_lu - x_ie) << ", min-sr-flex = " << std::fabs(x_flex - x_ie) << std::endl;
+
+        /// All of them converge to the same collocation solution, the LU trick in far fewer sweeps when stiff
+        if(std::fabs(x_lu - x_ie) > 1e-10 || std::fabs(x_flex - x_ie) > 1e-10)
+            return 1;
+        if(lu > ie || (lambdas[l] > 1 && 2 * lu > ie))
+            return 1;
+    }
+    return 0;
+}
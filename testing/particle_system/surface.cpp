@@ -0,0 +1,164 @@
+#include<iostream>
+#include<cmath>
+#include<vector>
+#include<list>
+#include<map>
+#include<algorithm>
+
+template<typename T>
+struct Traits;
+
+#include "particle_system/particle.hpp"
+#include "particle_system/surface.hpp"
+#include "particle_system/storage/particle_system_storage.hpp"
+#include "math/ode_solver/sdc/integrator/spectral_integrator.hpp"
+#include "math/ode_solver/sdc/explicit_sdc.hpp"
+#include "math/ode_solver/sdc/semi_implicit_sdc.hpp"
+#include "math/ode_solver/sdc/stiffness_switching_sdc.hpp"
+#include "math/ode_solver/sdc/multilevel_sdc.hpp"
+#include "math/ode_solver/ark/additive_runge_kutta.hpp"
+#include "math/ode_solver/step_control/step_size_controller.hpp"
+
+/**
+ * Rotation about the z axis (explicit part) and a stiff relaxation to the origin (implicit part),
+ * the exact solution is exp(-lambda*t) times the rotated initial positions.
+ **/
+struct relaxation_solver
+{
+    static const double omega;
+    static const double lambda;
+    size_t m_size;
+    relaxation_solver(size_t num_particles) : m_size(3 * num_particles) {}
+
+    void operator()(double t, const double *x, double *v, const double *f)
+    {
+        Explicit(t, x, v, f);
+        for(size_t i = 0; i < m_size; ++i)
+            v[i] -= lambda * x[i];
+    }
+    void Explicit(double , const double *x, double *v, const double *)
+    {
+        for(size_t i = 0; i < m_size; i += 3)
+        {
+            v[i] = -omega * x[i + 1];
+            v[i + 1] = omega * x[i];
+            v[i + 2] = 0;
+        }
+    }
+    void Implicit(double , const double *x, double *v, const double *)
+    {
+        for(size_t i = 0; i < m_size; ++i)
+            v[i] = -lambda * x[i];
+    }
+};
+const double relaxation_solver::omega = 1;
+const double relaxation_solver::lambda = 20;
+
+template<typename time_integrator>
+class TestSurface : public Surface<TestSurface<time_integrator> >
+{
+    public:
+        typedef Surface<TestSurface<time_integrator> > base_type;
+
+        TestSurface(size_t num_particles) : base_type(num_particles)
+        {
+            double *x = this->positions();
+            for(size_t i = 0; i < this->data_size(); ++i)
+                x[i] = std::cos(double(i));
+            (*this)(this->time(), x, this->velocities());
+        }
+
+        inline void computeForces(double) { this->clearForces(); }
+
+        /**
+         * Largest difference with the exact solution at time(), x0 are the initial positions.
+         **/
+        double error(const std::vector<double> &x0)
+        {
+            double t = this->time(), c = std::cos(relaxation_solver::omega * t), s = std::sin(relaxation_solver::omega * t);
+            double decay = std::exp(-relaxation_solver::lambda * t), error = 0;
+            const double *x = this->positions();
+            for(size_t i = 0; i < x0.size(); i += 3)
+            {
+                double exact[3] = {decay * (c * x0[i] - s * x0[i + 1]), decay * (s * x0[i] + c * x0[i + 1]), decay * x0[i + 2]};
+                for(int k = 0; k < 3; ++k)
+                    error = std::max(error, std::fabs(x[i + k] - exact[k]));
+            }
+            return error;
+        }
+};
+
+template<typename time_integrator>
+struct Traits<TestSurface<time_integrator> >
+{
+    typedef double value_type;
+    typedef relaxation_solver fluid_solver_type;
+    typedef time_integrator time_integrator_type;
+    typedef ParticleWrapper<value_type> particle_type;
+    typedef ParticleSystemStorage<value_type, particle_type, SURFACE> storage_type;
+};
+
+/**
+ * Surface::run(timestep, controller) up to t = 1 starting with a step of dt.
+ **/
+template<typename time_integrator>
+bool adaptive_run(const char *name, double dt)
+{
+    TestSurface<time_integrator> surface(4);
+    std::vector<double> x0(surface.positions(), surface.positions() + surface.data_size());
+    StepSizeController<double> controller(1e-7, 1e-7);
+    controller.setStepLimits(1e-6, 1);
+    while(surface.time() < 1)
+        surface.run(dt, controller);
+    double error = surface.error(x0);
+    std::cout << name << ": " << controller.accepted() << " steps, " << controller.rejected() << " rejected, error = " << error << std::endl;
+    return controller.rejected() > 0 && error < 1e-5;
+}
+
+/**
+ * One step of dt taken with beginStep()/resumeStep(), after a step canceled half way.  The canceled
+ * step leaves time() and the state untouched, the completed one must match run(dt) bit for bit.
+ **/
+template<typename time_integrator>
+bool piecewise_run(const char *name, double dt)
+{
+    TestSurface<time_integrator> reference(4), surface(4);
+    size_t size = surface.data_size();
+    std::vector<double> x0(surface.positions(), surface.positions() + size);
+    std::vector<double> v0(surface.velocities(), surface.velocities() + size);
+    reference.run(dt);
+
+    surface.beginStep(dt);
+    int pieces = 0;
+    for(; pieces < 3 && surface.resumeStep(); ++pieces);
+    surface.cancelStep();
+    bool unchanged = pieces == 3 && surface.time() == 0 && std::equal(x0.begin(), x0.end(), surface.positions()) && std::equal(v0.begin(), v0.end(), surface.velocities());
+
+    surface.beginStep(dt);
+    while(surface.resumeStep())
+        ++pieces;
+    bool identical = surface.time() == reference.time() && std::equal(surface.positions(), surface.positions() + size, reference.positions())
+                     && std::equal(surface.velocities(), surface.velocities() + size, reference.velocities());
+    std::cout << name << " piecewise: " << pieces << " pieces, canceled step " << (unchanged ? "left no trace" : "changed the state")
+              << ", completed step " << (identical ? "matches" : "differs from") << " run(dt)" << std::endl;
+    return unchanged && identical;
+}
+
+int surface(int , char **)
+{
+    typedef ExplicitSDC<double, Integrator<double, gauss_lobatto, 5>, 5> explicit_sdc;
+    typedef SemiImplicitSDC<double, Integrator<double, gauss_lobatto, 5>, 5> implicit_sdc;
+    typedef StiffnessSwitchingSDC<double, explicit_sdc, implicit_sdc> switching_sdc;
+    typedef AdditiveRungeKutta<double, ARK324L2SA> ark3;
+
+    /// The first trial step is far beyond the stability limit of the explicit method, its sweeps
+    /// diverge and the step is rejected instead of throwing
+    bool passed = adaptive_run<explicit_sdc>("explicit sdc", .5);
+    passed = adaptive_run<MultilevelSDC<double> >("multilevel sdc", .5) && passed;
+    passed = adaptive_run<switching_sdc>("switching sdc", .5) && passed;
+    passed = adaptive_run<ark3>("ark3", .5) && passed;
+
+    passed = piecewise_run<explicit_sdc>("explicit sdc", .01) && passed;
+    passed = piecewise_run<implicit_sdc>("semi-implicit sdc", .1) && passed;
+    return passed ? 0 : 1;
+}
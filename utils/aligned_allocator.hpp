@@ -0,0 +1,77 @@
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cstdlib>
+#include<cstddef>
+#include<new>
+
+/**
+ * \brief Standard allocator returning memory aligned to a cache line (or any power of two
+ *  multiple of sizeof(void*)).  Use it with std::vector for buffers touched by SIMD loops.
+ **/
+template<typename T, size_t alignment = 64>
+class AlignedAllocator
+{
+    public:
+        typedef T               value_type;
+        typedef T               *pointer;
+        typedef const T         *const_pointer;
+        typedef T               &reference;
+        typedef const T         &const_reference;
+        typedef size_t          size_type;
+        typedef std::ptrdiff_t  difference_type;
+
+        template<typename U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, alignment> other;
+        };
+
+        AlignedAllocator() {}
+        AlignedAllocator(const AlignedAllocator &) {}
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, alignment> &) {}
+
+        inline pointer address(reference x) const { return &x; }
+        inline const_pointer address(const_reference x) const { return &x; }
+        inline size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+        inline pointer allocate(size_type n, const void * = 0)
+        {
+            if(n == 0)
+                return 0;
+            void *p = 0;
+            if(posix_memalign(&p, alignment, n * sizeof(T)) != 0)
+                throw std::bad_alloc();
+            return static_cast<pointer>(p);
+        }
+
+        inline void deallocate(pointer p, size_type)
+        {
+            std::free(p);
+        }
+
+        inline void construct(pointer p, const T &value) { new(p) T(value); }
+        inline void destroy(pointer p) { p->~T(); }
+
+        inline bool operator==(const AlignedAllocator &) const { return true; }
+        inline bool operator!=(const AlignedAllocator &) const { return false; }
+};
+
+#endif
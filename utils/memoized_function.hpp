@@ -0,0 +1,216 @@
+#ifndef MEMOIZED_FUNCTION_HPP
+#define MEMOIZED_FUNCTION_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<cmath>
+#include<limits>
+#include<algorithm>
+
+#include "utils/meta.hpp"
+#include "utils/ring_buffer.hpp"
+
+/**
+ * \brief Last right hand side evaluations, keyed by the time and the state they were evaluated at.
+ *
+ *  The latest evaluation at each of the last capacity times is kept.  The iterates of an implicit
+ *  solve then replace each other, and the evaluations at the end of a step survive the next step,
+ *  e.g. when it is rejected and started over.
+ *
+ *  The key is the time plus the contents of the state, and optionally of a second vector the
+ *  evaluation depends on (e.g. the forces).  The integrators overwrite their node vectors in place,
+ *  so a pointer alone does not identify a state.  Comparing the contents is O(n), far cheaper than
+ *  the evaluation it may save.  Times match up to a few ulps, since the node times are accumulated
+ *  in a different order from step to step.
+ *
+ *  Every entry is tagged with the accuracy requested when it was evaluated, see requestAccuracy().
+ *  It is only returned when that accuracy is as tight as the current one, 0 being full accuracy.
+ *  Call invalidate() when anything else the right hand side depends on changes.
+ **/
+template<typename value_type>
+class RhsCache
+{
+    private:
+        size_t                  m_capacity;
+        RingBuffer<value_type>  m_keys;         //< States and extra keys, keyed by time
+        RingBuffer<value_type>  m_values;       //< Right hand sides, keyed by their accuracy
+        value_type              m_accuracy;
+        size_t                  m_hits;
+        size_t                  m_misses;
+
+    public:
+        RhsCache(size_t capacity = 0) : m_capacity(capacity), m_keys(1, 0), m_values(1, 0), m_accuracy(0), m_hits(0), m_misses(0) {}
+
+        /**
+         * \brief Number of evaluations kept, 0 disables the cache.
+         **/
+        inline void setCapacity(size_t capacity)
+        {
+            m_capacity = capacity;
+            m_keys = RingBuffer<value_type>(1, 0);
+            m_values = RingBuffer<value_type>(1, 0);
+        }
+        inline bool enabled() const { return m_capacity > 0; }
+        inline void setAccuracy(value_type tol) { m_accuracy = tol; }
+        inline void invalidate() { m_keys.clear(); m_values.clear(); }
+        inline size_t hits() const { return m_hits; }
+        inline size_t misses() const { return m_misses; }
+
+        /**
+         * \brief Copies the cached F(t,x) into v.  y of size y_size is an extra key.
+         *
+         * \return false if it is not in the cache.
+         **/
+        bool lookup(value_type t, const value_type *x, size_t x_size, value_type *v, size_t v_size, const value_type *y = 0, size_t y_size = 0)
+        {
+            if(!enabled())
+                return false;
+            if(m_keys.vector_size() == x_size + y_size && m_values.vector_size() == v_size)
+            {
+                for(size_t i = 0; i < m_keys.size(); ++i)
+                {
+                    value_type accuracy = m_values.key(i);
+                    if(!same_time(m_keys.key(i), t) || (accuracy > 0 && (m_accuracy == 0 || accuracy > m_accuracy)))
+                        continue;
+                    const value_type *key = m_keys[i];
+                    if(std::equal(x, x + x_size, key) && (y_size == 0 || std::equal(y, y + y_size, key + x_size)))
+                    {
+                        std::copy(m_values[i], m_values[i] + v_size, v);
+                        ++m_hits;
+                        return true;
+                    }
+                }
+            }
+            ++m_misses;
+            return false;
+        }
+
+        /**
+         * \brief Adds v = F(t,x).  It replaces the entry at the same time if there is one, else the
+         *  entry at the oldest time.
+         **/
+        void store(value_type t, const value_type *x, size_t x_size, const value_type *v, size_t v_size, const value_type *y = 0, size_t y_size = 0)
+        {
+            if(!enabled())
+                return;
+            if(m_keys.vector_size() != x_size + y_size || m_values.vector_size() != v_size || m_keys.capacity() != m_capacity)
+            {
+                m_keys = RingBuffer<value_type>(m_capacity, x_size + y_size);
+                m_values = RingBuffer<value_type>(m_capacity, v_size);
+            }
+            value_type *key = 0, *value = 0;
+            for(size_t i = 0; i < m_keys.size() && !key; ++i)
+                if(same_time(m_keys.key(i), t))
+                {
+                    key = m_keys[i];
+                    value = m_values[i];
+                    m_values.key(i) = m_accuracy;
+                }
+            if(!key)
+            {
+                key = m_keys.push(t);
+                value = m_values.push(m_accuracy);
+            }
+            std::copy(x, x + x_size, key);
+            if(y_size > 0)
+                std::copy(y, y + y_size, key + x_size);
+            std::copy(v, v + v_size, value);
+        }
+
+    private:
+        inline bool same_time(value_type t0, value_type t1) const
+        {
+            return std::fabs(t0 - t1) <= 16 * std::numeric_limits<value_type>::epsilon() * std::max(std::fabs(t1), value_type(1));
+        }
+};
+
+/**
+ * \brief Right hand side wrapper that returns the cached result when F, F.Explicit or F.Implicit
+ *  is evaluated again at the same time and state, see RhsCache.  It can be passed to the time
+ *  integrators in place of F.  Evaluations repeat e.g. when a rejected step starts over, when
+ *  BackwardEuler::linearize() evaluates F at the start of the step, or at the stiffness checks of
+ *  StiffnessSwitchingSDC.
+ **/
+template<typename function_type, typename value_type>
+class MemoizedFunction
+{
+    private:
+        function_type &m_F;
+        RhsCache<value_type> m_cache[3];    //< operator(), Explicit and Implicit
+
+    public:
+        MemoizedFunction(function_type &F, size_t capacity = 4) : m_F(F)
+        {
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].setCapacity(capacity);
+        }
+
+        inline function_type &function() { return m_F; }
+        inline size_t ode_size() { return m_F.ode_size(); }
+
+        inline void operator()(value_type t, const value_type *x, value_type *v)
+        {
+            if(!m_cache[0].lookup(t, x, ode_size(), v, ode_size()))
+            {
+                m_F(t, const_cast<value_type*>(x), v);
+                m_cache[0].store(t, x, ode_size(), v, ode_size());
+            }
+        }
+
+        inline void Explicit(value_type t, const value_type *x, value_type *v)
+        {
+            if(!m_cache[1].lookup(t, x, ode_size(), v, ode_size()))
+            {
+                m_F.Explicit(t, const_cast<value_type*>(x), v);
+                m_cache[1].store(t, x, ode_size(), v, ode_size());
+            }
+        }
+
+        inline void Implicit(value_type t, const value_type *x, value_type *v)
+        {
+            if(!m_cache[2].lookup(t, x, ode_size(), v, ode_size()))
+            {
+                m_F.Implicit(t, const_cast<value_type*>(x), v);
+                m_cache[2].store(t, x, ode_size(), v, ode_size());
+            }
+        }
+
+        /**
+         * \brief Forwarded to F if it has setAccuracy(), later lookups only return entries at
+         *  least as accurate.
+         **/
+        inline void setAccuracy(value_type tol)
+        {
+            requestAccuracy(m_F, tol);
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].setAccuracy(tol);
+        }
+
+        /**
+         * \brief Drop the cached evaluations, e.g. after a parameter of F changed.
+         **/
+        inline void invalidate()
+        {
+            for(int i = 0; i < 3; ++i)
+                m_cache[i].invalidate();
+        }
+
+        inline size_t hits() const { return m_cache[0].hits() + m_cache[1].hits() + m_cache[2].hits(); }
+        inline size_t misses() const { return m_cache[0].misses() + m_cache[1].misses() + m_cache[2].misses(); }
+};
+
+#endif
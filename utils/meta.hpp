@@ -46,6 +46,49 @@ struct StaticAssert<true> { enum {WRONG_QUADRATURE_CHOSEN}; };
                 || TYPE::quadrature == clenshaw_curtis), \
                 WRONG_TYPE_OF_QUADRATURE)
 
+/**
+ * \brief Declares has_member_NAME<T>::value, true if the class T (or a base) has a member called
+ *  NAME of any kind.  T::NAME is made ambiguous with the member of a fallback base, so the check
+ *  also sees inherited and overloaded members.
+ **/
+#define DECLARE_HAS_MEMBER(NAME) \
+    template<typename T> \
+    struct has_member_##NAME \
+    { \
+        typedef char yes[1]; \
+        typedef char no[2]; \
+        struct fallback { int NAME; }; \
+        struct derived : T, fallback {}; \
+        template<typename U, U> struct check; \
+        template<typename U> static no &test(check<int fallback::*, &U::NAME>*); \
+        template<typename U> static yes &test(...); \
+        enum { value = sizeof(test<derived>(0)) == sizeof(yes) }; \
+    };
 
+DECLARE_HAS_MEMBER(setAccuracy)
+
+template<bool has_accuracy_control>
+struct AccuracyRequest
+{
+    template<typename function_type, typename value_type>
+    static inline void apply(function_type &, value_type) {}
+};
+
+template<>
+struct AccuracyRequest<true>
+{
+    template<typename function_type, typename value_type>
+    static inline void apply(function_type &F, value_type tol) { F.setAccuracy(tol); }
+};
+
+/**
+ * \brief Passes the tolerance requested for the next evaluations to F.setAccuracy(tol), a no-op
+ *  for right hand sides without it.
+ **/
+template<typename function_type, typename value_type>
+inline void requestAccuracy(function_type &F, value_type tol)
+{
+    AccuracyRequest<has_member_setAccuracy<function_type>::value>::apply(F, tol);
+}
 
 #endif
@@ -0,0 +1,94 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+/****************************************************************************
+** MOOPS -- Modular Object Oriented Particle Simulator
+** Copyright (C) 2011-2012  Ricardo Ortiz <ortiz@unc.edu>
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+****************************************************************************/
+#include<vector>
+#include<algorithm>
+
+/**
+ * \brief Fixed capacity history of vectors, each one tagged with a key (e.g. a time level).
+ *  Storage is allocated once.  Pushing on a full buffer overwrites the oldest entry.
+ *  Entries are indexed from the newest, (*this)[0] is the last pushed vector.
+ **/
+template<typename value_type>
+class RingBuffer
+{
+    private:
+        size_t                  m_capacity;
+        size_t                  m_vector_size;
+        size_t                  m_size;
+        size_t                  m_head;     //< Slot of the newest entry
+        std::vector<value_type> m_data;
+        std::vector<value_type> m_keys;
+
+    public:
+        RingBuffer(size_t capacity, size_t vector_size) :
+                m_capacity(capacity),
+                m_vector_size(vector_size),
+                m_size(0),
+                m_head(0),
+                m_data(capacity * vector_size),
+                m_keys(capacity)
+        {}
+
+        inline size_t size() const { return m_size; }
+        inline size_t capacity() const { return m_capacity; }
+        inline size_t vector_size() const { return m_vector_size; }
+        inline bool empty() const { return m_size == 0; }
+        inline bool full() const { return m_size == m_capacity; }
+        inline void clear() { m_size = 0; }
+
+        inline value_type *operator[](size_t i) { return &m_data[slot(i) * m_vector_size]; }
+        inline const value_type *operator[](size_t i) const { return &m_data[slot(i) * m_vector_size]; }
+        inline value_type &key(size_t i) { return m_keys[slot(i)]; }
+        inline const value_type &key(size_t i) const { return m_keys[slot(i)]; }
+
+        /**
+         * \brief Adds a new entry and returns its storage.
+         **/
+        inline value_type *push(value_type key)
+        {
+            m_head = (m_head + 1) % m_capacity;
+            if(m_size < m_capacity)
+                ++m_size;
+            m_keys[m_head] = key;
+            return &m_data[m_head * m_vector_size];
+        }
+
+        inline void push(value_type key, const value_type *x)
+        {
+            value_type *y = push(key);
+            std::copy(x, x + m_vector_size, y);
+        }
+
+        /**
+         * \brief Removes the newest entry.
+         **/
+        inline void pop()
+        {
+            if(m_size == 0)
+                return;
+            m_head = (m_head + m_capacity - 1) % m_capacity;
+            --m_size;
+        }
+
+    private:
+        inline size_t slot(size_t i) const { return (m_head + m_capacity - i) % m_capacity; }
+};
+
+#endif